@@ -75,6 +75,20 @@ public:
   virtual hwctx_handle*
   get_hwctx_handle() const = 0;
 
+  // get_completion_lane() - key of in-order completion lane
+  //
+  // Commands with same lane key are expected to complete in the
+  // order in which they were submitted.  The command manager uses
+  // this to check only the oldest commands of a lane for completion.
+  // Default is no_lane, which implies no ordering guarantees.
+  static constexpr uint64_t no_lane = 0;
+
+  virtual uint64_t
+  get_completion_lane() const
+  {
+    return no_lane;
+  }
+
 private:
   unsigned long m_uid;
 };
@@ -10,8 +10,10 @@
 #include "fence_int.h"
 #include "kernel_int.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/debug.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
 #include "core/common/thread.h"
 #include "core/include/ert.h"
 #include "core/include/xrt_hwqueue.h"
@@ -23,10 +25,13 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <thread>
+#include <unordered_map>
 
 using namespace std::chrono_literals;
 
@@ -78,6 +83,156 @@ notify_host(xrt_core::command* cmd)
   notify_host(cmd, get_command_state(cmd));
 }
 
+// class scan_tracker - running commands in submission order
+//
+// All running commands are checked for completion each time the
+// monitor thread returns from exec_wait.  This is the default.
+class scan_tracker
+{
+  std::vector<xrt_core::command*> m_running;
+  std::vector<xrt_core::command*> m_busy;
+
+public:
+  [[nodiscard]] bool
+  empty() const
+  {
+    return m_running.empty();
+  }
+
+  void
+  add(xrt_core::command* cmd)
+  {
+    m_running.push_back(cmd);
+  }
+
+  // Notify all completed commands, preserve order of processing.
+  // Return number of commands notified.
+  size_t
+  notify_completed()
+  {
+    size_t notified = 0;
+    for (auto cmd : m_running) {
+      if (completed(cmd)) {
+        notify_host(cmd);
+        ++notified;
+      }
+      else
+        m_busy.push_back(cmd);
+    }
+
+    m_running.swap(m_busy);
+    m_busy.clear();
+    return notified;
+  }
+};
+
+// class lane_tracker - running commands grouped by completion lane
+//
+// Commands are kept per lane in submission order, see
+// xrt_core::command::get_completion_lane().  Within a lane only the
+// oldest commands are checked for completion, the scan stops at the
+// first command that is still running.  Each completion therefore
+// touches only the heads of the lanes rather than all running
+// commands in the lanes.
+//
+// Lanes are stored contiguously and indexed by lane key, so adding a
+// command to a lane and removing a drained lane are O(1).  Lanes that
+// become empty are removed so that lane keys of destroyed hw contexts
+// do not accumulate stale entries.
+//
+// Commands without a lane (no_lane) have no ordering guarantees and
+// are checked for completion individually as in scan_tracker.
+class lane_tracker
+{
+  struct lane
+  {
+    uint64_t key;
+    std::deque<xrt_core::command*> cmds;
+  };
+
+  std::vector<lane> m_lanes;
+  std::unordered_map<uint64_t, size_t> m_index;  // lane key -> m_lanes index
+  scan_tracker m_unordered;
+  size_t m_size = 0;
+
+  // Remove lane at idx by moving the last lane in its place
+  void
+  remove_lane(size_t idx)
+  {
+    m_index.erase(m_lanes[idx].key);
+    if (idx != m_lanes.size() - 1) {
+      m_lanes[idx] = std::move(m_lanes.back());
+      m_index[m_lanes[idx].key] = idx;
+    }
+    m_lanes.pop_back();
+  }
+
+public:
+  [[nodiscard]] bool
+  empty() const
+  {
+    return m_size == 0 && m_unordered.empty();
+  }
+
+  void
+  add(xrt_core::command* cmd)
+  {
+    auto key = cmd->get_completion_lane();
+    if (key == xrt_core::command::no_lane) {
+      m_unordered.add(cmd);
+      return;
+    }
+
+    auto [itr, inserted] = m_index.emplace(key, m_lanes.size());
+    if (inserted)
+      m_lanes.push_back({key, {}});
+    m_lanes[itr->second].cmds.push_back(cmd);
+    ++m_size;
+  }
+
+  // Notify completed commands at the head of each lane and completed
+  // commands without a lane.  Return number of commands notified.
+  size_t
+  notify_completed()
+  {
+    size_t notified = m_unordered.notify_completed();
+    for (size_t idx = 0; idx < m_lanes.size();) {
+      auto& cmds = m_lanes[idx].cmds;
+      while (!cmds.empty() && completed(cmds.front())) {
+        auto cmd = cmds.front();
+        cmds.pop_front();
+        --m_size;
+        ++notified;
+        notify_host(cmd);
+      }
+
+      if (cmds.empty())
+        remove_lane(idx);  // idx now refers to the moved lane
+      else
+        ++idx;
+    }
+    return notified;
+  }
+};
+
+// struct executor - interface for command submission and wait
+//
+// Implemented by hw queue and used by command_manager and
+// command_worker for managed command execution.
+struct executor
+{
+  virtual std::cv_status
+  wait(size_t timeout_ms) = 0;
+
+  virtual void
+  submit(xrt_core::command* cmd) = 0;
+
+  // Submit commands in order.  On return, also if submission throws,
+  // @submitted is the number of commands that were submitted.
+  virtual void
+  submit(const std::vector<xrt_core::command*>& cmds, size_t& submitted) = 0;
+};
+
 // class command_manager - managed command executuon
 //
 // @m_qimpl: The hw queue used for command submission
@@ -85,6 +240,7 @@ notify_host(xrt_core::command* cmd)
 // @work_cond: Kick off monitor thread when there are new commands
 // @monitor_thread: Thread for asynchronous monitoring of command execution
 // @stop: Stop the monitor thread
+// @m_lanes: Track running commands per completion lane (optional)
 //
 // This is constructed on demand when commands are submitted for managed
 // execution through a command queue.  Managed execution means that
@@ -96,22 +252,12 @@ notify_host(xrt_core::command* cmd)
 // by which ever object (hw queue) uses the manager.
 class command_manager
 {
-public:
-  struct executor
-  {
-    virtual std::cv_status
-    wait(size_t timeout_ms) = 0;
-
-    virtual void
-    submit(xrt_core::command* cmd) = 0;
-  };
-
-private:
   executor* m_impl;
   std::mutex work_mutex;
   std::condition_variable work_cond;
   command_queue_type submitted_cmds;
   bool stop = false;
+  bool m_lanes = xrt_core::config::get_cmd_completion_lanes();
 
   // thread can be constructed only after data members are initialized
   std::thread monitor_thread;
@@ -123,11 +269,15 @@ private:
   //
   // Commands that are submitted for execution using managed_start()
   // are monitored for completion by this function.
+  //
+  // The Tracker type determines how running commands are checked
+  // for completion, see scan_tracker and lane_tracker.
+  template <typename Tracker>
   void
   monitor_loop()
   {
-    std::vector<xrt_core::command*> busy_cmds;
-    std::vector<xrt_core::command*> running_cmds;
+    Tracker running_cmds;
+    command_queue_type drained_cmds;
 
     while (true) {
 
@@ -161,22 +311,15 @@ private:
       // in either running_cmds or submitted_cmds.
       {
         std::lock_guard<std::mutex> lk(work_mutex);
-        std::copy(submitted_cmds.begin(), submitted_cmds.end(), std::back_inserter(running_cmds));
-        submitted_cmds.clear();
+        drained_cmds.swap(submitted_cmds);
       }
       // At this point running_cmds is guaranteed to contain the
       // command(s) for which exec_wait returned.
+      for (auto cmd : drained_cmds)
+        running_cmds.add(cmd);
 
-      // Preserve order of processing
-      for (auto cmd : running_cmds) {
-        if (completed(cmd))
-          notify_host(cmd);
-        else
-          busy_cmds.push_back(cmd);
-      }
-
-      running_cmds.swap(busy_cmds);
-      busy_cmds.clear();
+      drained_cmds.clear();
+      running_cmds.notify_completed();
     } // while (1)
   }
 
@@ -185,7 +328,10 @@ private:
   monitor()
   {
     try {
-      monitor_loop();
+      if (m_lanes)
+        monitor_loop<lane_tracker>();
+      else
+        monitor_loop<scan_tracker>();
     }
     catch (const std::exception& ex) {
       std::string msg = std::string("kds command monitor died unexpectedly: ") + ex.what();
@@ -275,6 +421,344 @@ public:
     // exec_buf call so that actual execution doesn't have to wait.
     work_cond.notify_one();
   }
+
+  // launch() - Submit a batch of commands for managed execution
+  //
+  // Same as launching the commands one at a time, but the commands
+  // are stored for completion tracking and the monitor thread is
+  // notified once for the entire batch.
+  void
+  launch(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+  {
+    {
+      std::lock_guard<std::mutex> lk(work_mutex);
+      submitted_cmds.insert(submitted_cmds.end(), cmds.begin(), cmds.end());
+    }
+
+    submitted = 0;
+    try {
+      m_impl->submit(cmds, submitted);
+    }
+    catch (...) {
+      // Remove the commands that were not submitted
+      std::lock_guard<std::mutex> lk(work_mutex);
+      auto first = cmds.begin() + submitted;
+      submitted_cmds.erase
+        (std::remove_if(submitted_cmds.begin(), submitted_cmds.end(),
+                        [first, last = cmds.end()](auto cmd) { return std::find(first, last, cmd) != last; }),
+         submitted_cmds.end());
+      if (submitted)
+        work_cond.notify_one();
+      throw;
+    }
+
+    work_cond.notify_one();
+  }
+};
+
+// class command_worker - managed command execution shared by hw queues
+//
+// @m_idx: Index of this worker in the worker pool
+// @work_mutex: Synchronize worker thread with launched commands
+// @work_cond: Kick off worker thread when there are new commands
+// @submitted_cmds: Commands launched but not yet monitored
+// @m_stats: Worker statistics
+// @monitor_thread: Thread for asynchronous monitoring of command execution
+//
+// When xrt.ini Runtime.cmd_monitor_threads is set, a fixed pool of
+// workers replaces the per hw queue command_manager.  A hw queue is
+// assigned to the least loaded worker on its first managed start
+// and all managed commands of the queue are monitored by that
+// worker.
+//
+// The worker follows the same protocol as command_manager, but since
+// exec_wait can block on one queue only, a worker serving more than
+// one queue checks all running commands for completion and waits
+// only if none completed, each time on the next queue with pending
+// work using a short timeout.  A worker serving a single queue
+// blocks in exec_wait in longer slices and stops blocking when
+// another queue is assigned to it.
+//
+// Commands cannot be launched after the worker is shut down, but
+// commands launched before are monitored until they complete, see
+// stop_monitor_threads().
+class command_worker
+{
+public:
+  struct stats
+  {
+    std::atomic<uint64_t> queues {0};    // currently assigned hw queues
+    std::atomic<uint64_t> launched {0};  // commands launched
+    uint64_t completed = 0;              // commands notified of completion
+    uint64_t waits = 0;                  // calls to exec wait
+    uint64_t timeouts = 0;               // exec wait timeouts
+  };
+
+private:
+  struct submitted_cmd
+  {
+    executor* exec;
+    xrt_core::command* cmd;
+  };
+
+  // Wait timeout when worker serves multiple hw queues
+  static constexpr size_t poll_interval_ms = 1;
+
+  // Wait timeout when worker blocks on a single hw queue
+  static constexpr size_t block_interval_ms = 10;
+
+  unsigned int m_idx;
+  std::mutex work_mutex;
+  std::condition_variable work_cond;
+  std::vector<submitted_cmd> submitted_cmds;
+  bool stop = false;
+  std::atomic<bool> m_wake {false};  // stop blocking on a single queue
+  bool m_lanes = xrt_core::config::get_cmd_completion_lanes();
+  stats m_stats;
+
+  // thread can be constructed only after data members are initialized
+  std::thread monitor_thread;
+
+  template <typename Tracker>
+  void
+  monitor_loop()
+  {
+    std::unordered_map<executor*, Tracker> running_cmds;
+    std::vector<submitted_cmd> drained_cmds;
+    std::vector<executor*> active;
+    size_t next = 0;
+
+    // A queue can be deleted as result of notifying its last
+    // command, the queue is not accessed after notification.
+    auto notify_completed = [this, &running_cmds] {
+      size_t notified = 0;
+      for (auto itr = running_cmds.begin(); itr != running_cmds.end();) {
+        notified += itr->second.notify_completed();
+        itr = itr->second.empty() ? running_cmds.erase(itr) : std::next(itr);
+      }
+      m_stats.completed += notified;
+      return notified;
+    };
+
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lk(work_mutex);
+        while (!stop && running_cmds.empty() && submitted_cmds.empty())
+          work_cond.wait(lk);
+
+        // Stop when all launched commands have been notified
+        if (stop && running_cmds.empty() && submitted_cmds.empty())
+          return;
+
+        m_wake = false;
+
+        // Queues with submitted commands must be waited on before
+        // their commands are drained, see command_manager.  Commands
+        // keep their hw queue alive while submitted or running.
+        active.clear();
+        for (const auto& sc : submitted_cmds)
+          active.push_back(sc.exec);
+      }
+
+      // Running commands that completed since last check are notified
+      // without waiting, waiting is needed only when none completed.
+      auto notified = notify_completed();
+
+      for (const auto& [exec, cmds] : running_cmds)
+        active.push_back(exec);
+
+      std::sort(active.begin(), active.end());
+      active.erase(std::unique(active.begin(), active.end()), active.end());
+
+      // A worker that serves multiple queues waits on one queue per
+      // iteration so that completion on any queue is seen within one
+      // poll interval.  A worker that serves a single queue can block
+      // in exec_wait until a command completes or another queue is
+      // assigned.
+      if (!notified && (m_stats.queues > 1 || active.size() > 1)) {
+        ++m_stats.waits;
+        if (active[next++ % active.size()]->wait(poll_interval_ms) == std::cv_status::timeout)
+          ++m_stats.timeouts;
+      }
+      else if (!notified && !active.empty()) {
+        do {
+          ++m_stats.waits;
+          if (active.front()->wait(block_interval_ms) == std::cv_status::no_timeout)
+            break;
+          ++m_stats.timeouts;
+        } while (!m_wake);
+      }
+
+      {
+        std::lock_guard<std::mutex> lk(work_mutex);
+        drained_cmds.swap(submitted_cmds);
+      }
+
+      for (const auto& sc : drained_cmds)
+        running_cmds[sc.exec].add(sc.cmd);
+
+      drained_cmds.clear();
+      notify_completed();
+    } // while (1)
+  }
+
+  void
+  monitor()
+  {
+    try {
+      if (m_lanes)
+        monitor_loop<lane_tracker>();
+      else
+        monitor_loop<scan_tracker>();
+    }
+    catch (const std::exception& ex) {
+      std::string msg = std::string("kds command worker died unexpectedly: ") + ex.what();
+      xrt_core::send_exception_message(msg.c_str());
+      s_exception = std::current_exception();
+    }
+    catch (...) {
+      xrt_core::send_exception_message("kds command worker died unexpectedly");
+      s_exception = std::current_exception();
+    }
+  }
+
+public:
+  // Constructor starts worker thread, optionally pinned to a cpu
+  command_worker(unsigned int idx, int cpu)
+    : m_idx(idx), monitor_thread(xrt_core::thread(&command_worker::monitor, this))
+  {
+    XRT_DEBUGF("command_worker::command_worker(%d) cpu(%d)\n", idx, cpu);
+    if (cpu >= 0)
+      xrt_core::detail::set_cpu_affinity(monitor_thread, static_cast<unsigned int>(cpu));
+  }
+
+  ~command_worker()
+  {
+    shutdown();
+  }
+
+  command_worker() = delete;
+  command_worker(const command_worker&) = delete;
+  command_worker(command_worker&&) = delete;
+  command_worker& operator=(const command_worker&) = delete;
+  command_worker& operator=(command_worker&&) = delete;
+
+  // Stop and join the worker thread, report statistics.  The thread
+  // exits after all commands launched before shutdown have completed
+  // and been notified.
+  void
+  shutdown()
+  {
+    {
+      std::lock_guard lk(work_mutex);
+      if (stop)
+        return;
+      stop = true;
+      m_wake = true;
+      work_cond.notify_one();
+    }
+    monitor_thread.join();
+
+    xrt_core::message::send
+      (xrt_core::message::severity_level::info, "XRT",
+       "command worker(%u) launched(%llu) completed(%llu) waits(%llu) timeouts(%llu)",
+       m_idx,
+       static_cast<unsigned long long>(m_stats.launched),
+       static_cast<unsigned long long>(m_stats.completed),
+       static_cast<unsigned long long>(m_stats.waits),
+       static_cast<unsigned long long>(m_stats.timeouts));
+  }
+
+  [[nodiscard]] const stats&
+  get_stats() const
+  {
+    return m_stats;
+  }
+
+  // Assign a queue to this worker, a worker that is blocked on
+  // its only other queue is woken up.
+  void
+  add_queue()
+  {
+    ++m_stats.queues;
+    m_wake = true;
+  }
+
+  void
+  remove_queue()
+  {
+    --m_stats.queues;
+  }
+
+  // launch() - Submit a command for managed execution
+  //
+  // Same as command_manager::launch() but with the hw queue used for
+  // submission and exec_wait passed explicitly.
+  void
+  launch(executor* exec, xrt_core::command* cmd)
+  {
+    XRT_DEBUGF("xrt_core::kds::command(%d) [new->submitted->running] worker(%d)\n", cmd->get_uid(), m_idx);
+
+    {
+      std::lock_guard<std::mutex> lk(work_mutex);
+      if (stop)
+        throw std::runtime_error("command worker is stopped, cannot launch command");
+      submitted_cmds.push_back({exec, cmd});
+    }
+
+    try {
+      exec->submit(cmd);
+    }
+    catch (...) {
+      // Remove the pending command, other queues may have
+      // launched commands after this one.
+      std::lock_guard<std::mutex> lk(work_mutex);
+      auto itr = std::find_if(submitted_cmds.rbegin(), submitted_cmds.rend(),
+                              [cmd](const auto& sc) { return sc.cmd == cmd; });
+      if (itr != submitted_cmds.rend())
+        submitted_cmds.erase(std::next(itr).base());
+      throw;
+    }
+
+    ++m_stats.launched;
+    work_cond.notify_one();
+  }
+
+  // launch() - Submit a batch of commands for managed execution
+  //
+  // Same as command_manager::launch() for a batch of commands.
+  void
+  launch(executor* exec, const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+  {
+    submitted = 0;
+    {
+      std::lock_guard<std::mutex> lk(work_mutex);
+      if (stop)
+        throw std::runtime_error("command worker is stopped, cannot launch commands");
+      for (auto cmd : cmds)
+        submitted_cmds.push_back({exec, cmd});
+    }
+
+    try {
+      exec->submit(cmds, submitted);
+    }
+    catch (...) {
+      // Remove the commands that were not submitted
+      std::lock_guard<std::mutex> lk(work_mutex);
+      auto first = cmds.begin() + submitted;
+      submitted_cmds.erase
+        (std::remove_if(submitted_cmds.begin(), submitted_cmds.end(),
+                        [first, last = cmds.end()](const auto& sc) { return std::find(first, last, sc.cmd) != last; }),
+         submitted_cmds.end());
+      m_stats.launched += submitted;
+      if (submitted)
+        work_cond.notify_one();
+      throw;
+    }
+
+    m_stats.launched += submitted;
+    work_cond.notify_one();
+  }
 };
 
 // Ideally a command manager should be owned by a hw_queue which
@@ -291,6 +775,75 @@ public:
 static std::vector<std::unique_ptr<command_manager>> s_command_manager_pool;
 static std::mutex s_pool_mutex;
 
+// Statically allocated command workers, created on first use when
+// xrt.ini Runtime.cmd_monitor_threads is set.  Workers are owned by
+// the pool, hw queues refer to their assigned worker.
+static std::vector<std::unique_ptr<command_worker>> s_command_worker_pool;
+
+// Parse comma separated list of cpus for command worker affinity.
+// Invalid entries are ignored with a warning.
+static std::vector<int>
+parse_command_worker_cpus()
+{
+  std::vector<int> cpus;
+  std::stringstream ss(xrt_core::config::get_cmd_monitor_cpus());
+  std::string tok;
+  auto max_cpus = std::thread::hardware_concurrency();
+  while (std::getline(ss, tok, ',')) {
+    if (tok.empty())
+      continue;
+
+    unsigned long cpu = 0;
+    try {
+      size_t end = 0;
+      cpu = std::stoul(tok, &end);
+      if (end != tok.size())
+        throw std::invalid_argument(tok);
+    }
+    catch (const std::exception&) {
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Ignoring invalid command worker affinity cpu '" + tok + "'");
+      continue;
+    }
+
+    if (cpu < max_cpus)
+      cpus.push_back(static_cast<int>(cpu));
+    else
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Ignoring command worker affinity to cpu #" + tok + " which is out of range");
+  }
+  return cpus;
+}
+
+static const std::vector<int>&
+get_command_worker_cpus()
+{
+  static const auto cpus = parse_command_worker_cpus();
+  return cpus;
+}
+
+// Get least loaded command worker, create the worker pool on first
+// use.  Must be called with s_pool_mutex locked.
+static command_worker*
+get_command_worker_nolock()
+{
+  if (s_command_worker_pool.empty()) {
+    const auto& cpus = get_command_worker_cpus();
+    auto workers = xrt_core::config::get_cmd_monitor_threads();
+    for (unsigned int idx = 0; idx < workers; ++idx) {
+      auto cpu = cpus.empty() ? -1 : cpus[idx % cpus.size()];
+      s_command_worker_pool.push_back(std::make_unique<command_worker>(idx, cpu));
+    }
+  }
+
+  auto itr = std::min_element(s_command_worker_pool.begin(), s_command_worker_pool.end(),
+                              [](const auto& lhs, const auto& rhs) {
+                                return lhs->get_stats().queues < rhs->get_stats().queues;
+                              });
+  (*itr)->add_queue();
+  return itr->get();
+}
+
 // At program exit, the command manager threads (monitor threads) must
 // be stopped and joined.  Normally this is done during static global
 // destruction, but in the OpenCL case a 'bad' program can exit before
@@ -299,9 +852,23 @@ static std::mutex s_pool_mutex;
 static void
 stop_monitor_threads()
 {
-    std::lock_guard lk(s_pool_mutex);
-    XRT_DEBUGF("stop_monitor_threads() pool(%d)\n", s_command_manager_pool.size());
-    s_command_manager_pool.clear();
+    std::vector<command_worker*> workers;
+    {
+      std::lock_guard lk(s_pool_mutex);
+      XRT_DEBUGF("stop_monitor_threads() pool(%d)\n", s_command_manager_pool.size());
+      s_command_manager_pool.clear();
+      for (auto& worker : s_command_worker_pool)
+        workers.push_back(worker.get());
+    }
+
+    // Workers may still be referenced by hw queues, stop the threads
+    // but keep the objects until static destruction.  Stopped workers
+    // reject further launches, a worker with running commands stops
+    // after the commands are notified so that waiters do not hang.
+    // The pool lock is not held since notification can delete a hw
+    // queue, which must lock the pool.
+    for (auto worker : workers)
+      worker->shutdown();
 }
 
 } // namespace
@@ -312,11 +879,26 @@ namespace xrt_core {
 //
 // Implements the interface required for both managed
 // and unmanaged execution.
-class hw_queue_impl : public command_manager::executor
+class hw_queue_impl : public executor
 {
   std::unique_ptr<command_manager> m_cmd_manager;
+  std::atomic<command_worker*> m_cmd_worker {nullptr};
   unsigned int m_uid = 0;
 
+  // Thread safe on-demand assignment of command worker
+  command_worker*
+  get_cmd_worker()
+  {
+    if (auto worker = m_cmd_worker.load())
+      return worker;
+
+    std::lock_guard lk(s_pool_mutex);
+    if (!m_cmd_worker)
+      m_cmd_worker = get_command_worker_nolock();
+
+    return m_cmd_worker;
+  }
+
   // Thread safe on-demand creation of m_cmd_manager
   command_manager*
   get_cmd_manager()
@@ -356,6 +938,10 @@ public:
       std::lock_guard lk(s_pool_mutex);
       s_command_manager_pool.push_back(std::move(m_cmd_manager));
     }
+    if (auto worker = m_cmd_worker.load()) {
+      std::lock_guard lk(s_pool_mutex);
+      worker->remove_queue();
+    }
   }
 
   hw_queue_impl(const hw_queue_impl&) = delete;
@@ -375,6 +961,15 @@ public:
   virtual void
   submit(xrt_core::command* cmd) = 0;  // NOLINT override from base
 
+  // Submit commands for execution one at a time.  Implementations
+  // that can submit multiple commands in one call override this.
+  void
+  submit(const std::vector<xrt_core::command*>& cmds, size_t& submitted) override
+  {
+    for (submitted = 0; submitted < cmds.size(); ++submitted)
+      submit(cmds[submitted]);
+  }
+
   // Wait for some command to finish
   virtual std::cv_status
   wait(size_t timeout_ms) = 0;         // NOLINT override from base
@@ -404,7 +999,11 @@ public:
   void
   managed_start(xrt_core::command* cmd)
   {
-    get_cmd_manager()->launch(cmd);
+    static const bool workers = xrt_core::config::get_cmd_monitor_threads() > 0;
+    if (workers)
+      get_cmd_worker()->launch(this, cmd);
+    else
+      get_cmd_manager()->launch(cmd);
   }
 
   // Unmanaged start submits command directly for execution
@@ -415,6 +1014,24 @@ public:
     submit(cmd);
   }
 
+  // Managed start of a batch of commands
+  void
+  managed_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+  {
+    static const bool workers = xrt_core::config::get_cmd_monitor_threads() > 0;
+    if (workers)
+      get_cmd_worker()->launch(this, cmds, submitted);
+    else
+      get_cmd_manager()->launch(cmds, submitted);
+  }
+
+  // Unmanaged start of a batch of commands
+  void
+  unmanaged_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+  {
+    submit(cmds, submitted);
+  }
+
 };
 
 // class qds_device - queue implementation for shim queue support
@@ -513,10 +1130,121 @@ public:
   }
 };
 
+// class spin_policy - adaptive busy poll of command state
+//
+// @m_max_us: Upper bound of spin window, 0 disables spinning
+// @m_window_us: Current spin window
+// @m_hits: Number of waits where command completed while spinning
+// @m_misses: Number of waits that fell back to blocking exec_wait
+//
+// For short running kernels the cost of exec_wait (poll syscall) and
+// the wakeup of waiting threads can exceed the execution time of the
+// kernel itself.  The spin policy busy polls the command state in the
+// exec buffer for a bounded window before the caller falls back to
+// blocking exec_wait.
+//
+// The window tunes itself from the observed wait latency.  If the
+// command completes within the max window, the window moves towards
+// twice the observed latency, otherwise the window is halved.  A long
+// running kernel therefore stops burning cpu on spinning, while the
+// window grows back as soon as short latencies are observed again.
+//
+// Only kds_device (legacy shim exec_wait) uses the spin policy.  The
+// qds_device backend waits through the shim hw queue and keeps its
+// existing wait path.
+class spin_policy
+{
+  const uint32_t m_max_us;
+  std::atomic<uint32_t> m_window_us;
+  std::atomic<uint64_t> m_hits {0};
+  std::atomic<uint64_t> m_misses {0};
+
+  static void
+  cpu_relax()
+  {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+  }
+
+  static ert_cmd_state
+  get_state(const ert_packet* pkt)
+  {
+    // Command state is updated asynchronously by driver / scheduler
+    auto header = reinterpret_cast<const volatile uint32_t*>(&pkt->header);
+    return static_cast<ert_cmd_state>(*header & 0xF); // state:4
+  }
+
+public:
+  explicit
+  spin_policy(uint32_t max_us)
+    : m_max_us(max_us), m_window_us(max_us)
+  {}
+
+  [[nodiscard]] bool
+  enabled() const
+  {
+    return m_max_us > 0;
+  }
+
+  // Spin on packet state for at most current window.
+  // Return true if command completed while spinning.
+  bool
+  spin(const ert_packet* pkt)
+  {
+    auto window = std::chrono::microseconds(m_window_us.load(std::memory_order_relaxed));
+    if (window.count() == 0) {
+      ++m_misses;
+      return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + window;
+    while (get_state(pkt) < ERT_CMD_STATE_COMPLETED) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        ++m_misses;
+        return false;
+      }
+      cpu_relax();
+    }
+
+    ++m_hits;
+    return true;
+  }
+
+  // Adjust spin window given latency of a completed wait
+  void
+  update(std::chrono::steady_clock::duration latency)
+  {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    uint32_t window = m_window_us.load(std::memory_order_relaxed);
+    if (us <= static_cast<int64_t>(m_max_us))
+      window = std::min<uint32_t>(m_max_us, (window + 2 * static_cast<uint32_t>(us) + 1) / 2);
+    else
+      window /= 2;
+    m_window_us.store(window, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t
+  get_hits() const
+  {
+    return m_hits;
+  }
+
+  [[nodiscard]] uint64_t
+  get_misses() const
+  {
+    return m_misses;
+  }
+};
+
 // class kds_device - queue implementation for legacy shim support
 //
 // @exec_wait_mutex: Synchronize access to exec_wait
 // @exec_wait_call_count:  Count of number of calls to exec wait
+// @m_serial: Unique id of this queue, never reused
+// @m_spin: Busy poll policy used prior to exec_wait for unmanaged commands
 class kds_device : public hw_queue_impl
 {
   xrt_core::device* m_device;
@@ -524,6 +1252,29 @@ class kds_device : public hw_queue_impl
   std::condition_variable m_work;
   uint64_t m_exec_wait_call_count {0};
   uint32_t m_exec_wait_active {0};
+  uint64_t m_serial {next_serial()};
+  spin_policy m_spin {xrt_core::config::get_exec_wait_spin_us()};
+
+  static uint64_t
+  next_serial()
+  {
+    static std::atomic<uint64_t> serial {0};
+    return serial++;
+  }
+
+  // Thread local count of exec wait calls seen by calling thread for
+  // the queue identified by @serial.  The counts are dropped when a
+  // thread has used more than a few queues, a dropped count makes the
+  // next exec_wait of the thread return early, which is harmless.
+  static uint64_t&
+  thread_exec_wait_call_count(uint64_t serial)
+  {
+    static constexpr size_t max_counts = 16;
+    static thread_local std::unordered_map<uint64_t, uint64_t> counts;
+    if (counts.size() >= max_counts && counts.find(serial) == counts.end())
+      counts.clear();
+    return counts[serial];
+  }
 
   // Thread safe shim level exec wait call.   This function allows
   // multiple threads to call exec_wait through same device handle.
@@ -535,11 +1286,12 @@ class kds_device : public hw_queue_impl
   // until some other unrelated command completes.  This function
   // prevents that scenario from happening.
   //
-  // Thread local storage keeps a call count that syncs with the
-  // number of times device::exec_wait has been called. If thread
-  // local call count is different from the global count, then this
-  // function resets the thread local call count and return without
-  // calling device::exec_wait.
+  // A per thread call count syncs with the number of times
+  // device::exec_wait has been called. If the thread's call count is
+  // different from the device count, then this function resets the
+  // thread's call count and return without calling device::exec_wait.
+  // The counts are kept per queue, a thread such as a command worker
+  // can call exec_wait on more than one device.
   //
   // In order to reduce multi-threaded wait time, condition variable
   // wait is used for subsequent threads calling this function while
@@ -556,13 +1308,15 @@ class kds_device : public hw_queue_impl
   std::cv_status
   exec_wait(size_t timeout_ms=0)
   {
-    static thread_local uint64_t thread_exec_wait_call_count = 0;
+    uint64_t* thread_call_count = nullptr;
 
     // Critical section to check if this thread needs to call
     // device::exec_wait or should wait on some other thread
     // completing the call.
     {
       std::unique_lock lk(m_exec_wait_mutex);
+      thread_call_count = &thread_exec_wait_call_count(m_serial);
+      auto& thread_exec_wait_call_count = *thread_call_count;
       if (thread_exec_wait_call_count != m_exec_wait_call_count) {
         // Some other thread has called exec_wait and may have
         // covered this thread's commands, synchronize thread
@@ -577,7 +1331,7 @@ class kds_device : public hw_queue_impl
         auto status = std::cv_status::no_timeout;
         if (timeout_ms) {
           status = (m_work.wait_for(lk, timeout_ms * 1ms,
-                                    [this] {
+                                    [this, &thread_exec_wait_call_count] {
                                       return thread_exec_wait_call_count != m_exec_wait_call_count;
                                     }))
             ? std::cv_status::no_timeout
@@ -585,7 +1339,7 @@ class kds_device : public hw_queue_impl
         }
         else {
           m_work.wait(lk,
-                      [this] {
+                      [this, &thread_exec_wait_call_count] {
                         return thread_exec_wait_call_count != m_exec_wait_call_count;
                       });
         }
@@ -625,7 +1379,7 @@ class kds_device : public hw_queue_impl
     // Acquire lock before updating shared state
     {
       std::lock_guard lk(m_exec_wait_mutex);
-      thread_exec_wait_call_count = ++m_exec_wait_call_count;
+      *thread_call_count = ++m_exec_wait_call_count;
       --m_exec_wait_active;
     }
 
@@ -641,6 +1395,23 @@ public:
     : m_device(device)
   {}
 
+  ~kds_device() override
+  {
+    if (!m_spin.enabled())
+      return;
+
+    xrt_core::message::send
+      (xrt_core::message::severity_level::info, "XRT",
+       "exec wait spin hits(%llu) misses(%llu)",
+       static_cast<unsigned long long>(m_spin.get_hits()),
+       static_cast<unsigned long long>(m_spin.get_misses()));
+  }
+
+  kds_device(const kds_device&) = delete;
+  kds_device(kds_device&&) = delete;
+  kds_device& operator=(const kds_device&) = delete;
+  kds_device& operator=(kds_device&&) = delete;
+
   std::cv_status
   wait(size_t timeout_ms) override
   {
@@ -651,6 +1422,19 @@ public:
   wait(const xrt_core::command* cmd, size_t timeout_ms) override
   {
     volatile auto pkt = cmd->get_ert_packet();
+
+    // Busy poll command state before blocking in exec_wait
+    if (m_spin.enabled()) {
+      auto start = std::chrono::steady_clock::now();
+      if (!m_spin.spin(pkt)) {
+        while (pkt->state < ERT_CMD_STATE_COMPLETED) {
+          if (exec_wait(timeout_ms) == std::cv_status::timeout)
+            return std::cv_status::timeout;
+        }
+      }
+      m_spin.update(std::chrono::steady_clock::now() - start);
+    }
+
     while (pkt->state < ERT_CMD_STATE_COMPLETED) {
       // return immediately on timeout
       if (exec_wait(timeout_ms) == std::cv_status::timeout)
@@ -883,6 +1667,20 @@ unmanaged_start(xrt_core::command* cmd)
   get_handle()->unmanaged_start(cmd);
 }
 
+void
+hw_queue::
+managed_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+{
+  get_handle()->managed_start(cmds, submitted);
+}
+
+void
+hw_queue::
+unmanaged_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+{
+  get_handle()->unmanaged_start(cmds, submitted);
+}
+
 void
 hw_queue::
 submit(xrt_core::buffer_handle* cmd)
@@ -56,6 +56,19 @@ public:
   void
   unmanaged_start(xrt_core::command* cmd);
 
+  // Start a batch of commands and manage their execution by
+  // monitoring for command completion.  The commands are submitted
+  // in order, completion tracking is set up once for the batch.
+  // On return, also if an exception is thrown, @submitted is the
+  // number of leading commands that were submitted.
+  void
+  managed_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted);
+
+  // Start a batch of commands with explicit completion control
+  // from application.  @submitted is as for managed_start().
+  void
+  unmanaged_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted);
+
   // Submit a raw cmd for execution
   void
   submit(xrt_core::buffer_handle* cmd);
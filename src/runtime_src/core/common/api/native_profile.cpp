@@ -4,11 +4,114 @@
 #define XRT_CORE_COMMON_SOURCE
 #include "native_profile.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/module_loader.h"
 #include "core/common/utils.h"
 #include "core/common/dlfcn.h"
+#include "core/common/message.h"
+#include "core/common/pointer_cache.h"
 #include "core/common/time.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Per API sampling state, keyed by the address of the API name, which
+// is always a string literal.  Lookups are lock free and nothing is
+// allocated once an API has been seen.  Entries are never removed.
+struct call_site
+{
+  enum : int { unknown = 0, selected, filtered };
+
+  std::atomic<int> state {unknown};
+  std::atomic<uint64_t> count {0};
+};
+
+xrt_core::pointer_cache<call_site, 1024> call_sites;
+
+// Shared by APIs that do not fit in the table
+call_site overflow_site;
+
+const std::vector<std::string>&
+selected_functions()
+{
+  static const std::vector<std::string> functions = [] {
+    std::vector<std::string> names;
+    std::string setting = xrt_core::config::get_native_xrt_trace_functions();
+    size_t start = 0;
+    while (start <= setting.size()) {
+      auto end = setting.find(',', start);
+      if (end == std::string::npos)
+        end = setting.size();
+      auto first = setting.find_first_not_of(' ', start);
+      auto last = setting.find_last_not_of(' ', end - 1);
+      if (first < end && last != std::string::npos && last >= first)
+        names.push_back(setting.substr(first, last - first + 1));
+      start = end + 1;
+    }
+    return names;
+  }();
+  return functions;
+}
+
+// An API is selected by its full name or by the class or namespace
+// it belongs to
+bool
+is_selected(const char* function)
+{
+  const auto& functions = selected_functions();
+  if (functions.empty())
+    return true;
+
+  for (const auto& name : functions) {
+    if (std::strncmp(function, name.c_str(), name.size()) != 0)
+      continue;
+    const char* rest = function + name.size();
+    if (*rest == '\0' || std::strncmp(rest, "::", 2) == 0)
+      return true;
+  }
+  return false;
+}
+
+call_site&
+find_call_site(const char* function)
+{
+  auto site = call_sites.get(function);
+  return site ? *site : overflow_site;
+}
+
+// Decide if this call of the API is traced
+bool
+sample(const char* function)
+{
+  static const uint64_t rate =
+    std::max<uint64_t>(xrt_core::config::get_native_xrt_trace_sample_rate(), 1);
+  static const bool filtering = !selected_functions().empty();
+
+  if (rate == 1 && !filtering)
+    return true;
+
+  auto& site = find_call_site(function);
+  if (filtering) {
+    auto state = site.state.load(std::memory_order_relaxed);
+    if (state == call_site::unknown || &site == &overflow_site) {
+      state = is_selected(function) ? call_site::selected : call_site::filtered;
+      if (&site != &overflow_site)
+        site.state.store(state, std::memory_order_relaxed);
+    }
+    if (state == call_site::filtered)
+      return false;
+  }
+
+  return rate == 1 || site.count.fetch_add(1, std::memory_order_relaxed) % rate == 0;
+}
+
+} // end anonymous namespace
+
 namespace xdp::native {
 
 void
@@ -23,10 +126,12 @@ load()
 // Callbacks for generic start/stop function tracking
 std::function<void (const char*, uint64_t)> function_start_cb ;
 std::function<void (const char*, uint64_t, uint64_t)> function_end_cb ;
+std::function<void (const char*, uint64_t, uint64_t, uint64_t)> function_complete_cb ;
 
 // Callbacks for individual functions to track start/stop and statistics
 std::function<void (const char*, uint64_t, bool)> sync_start_cb ;
 std::function<void (const char*, uint64_t, uint64_t, bool, uint64_t)> sync_end_cb ;
+std::function<void (const char*, uint64_t)> copy_path_cb ;
   
 void
 register_functions(void* handle)
@@ -34,7 +139,9 @@ register_functions(void* handle)
   using start_type      = void (*)(const char*, uint64_t) ;
   using sync_start_type = void (*)(const char*, uint64_t, bool) ;
   using end_type        = void (*)(const char*, uint64_t, uint64_t) ;
+  using complete_type   = void (*)(const char*, uint64_t, uint64_t, uint64_t) ;
   using end_sync_type   = void (*)(const char*, uint64_t, uint64_t, bool, uint64_t) ;
+  using copy_path_type  = void (*)(const char*, uint64_t) ;
 
   // Generic callbacks
   function_start_cb =
@@ -43,12 +150,24 @@ register_functions(void* handle)
   function_end_cb =
     reinterpret_cast<end_type>(xrt_core::dlsym(handle, "native_function_end")) ;
 
+  function_complete_cb =
+    reinterpret_cast<complete_type>(xrt_core::dlsym(handle, "native_function_complete")) ;
+
+  if (xrt_core::config::get_native_xrt_trace_min_duration_us() && !function_complete_cb)
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+      "native_xrt_trace_min_duration_us is ignored, the XDP native plugin "
+      "does not support it. All sampled calls are traced.");
+
   // Sync callbacks
   sync_start_cb =
     reinterpret_cast<sync_start_type>(xrt_core::dlsym(handle, "native_sync_start")) ;
 
   sync_end_cb =
     reinterpret_cast<end_sync_type>(xrt_core::dlsym(handle, "native_sync_end")) ;
+
+  // Copy callbacks
+  copy_path_cb =
+    reinterpret_cast<copy_path_type>(xrt_core::dlsym(handle, "native_copy_path")) ;
 }
 
 void warning_function()
@@ -76,19 +195,39 @@ generic_api_call_logger::
 generic_api_call_logger(const char* function)
   : api_call_logger(function)
 {
-  if (function_start_cb) {
-    m_funcid = xrt_core::utils::issue_id() ;
-    function_start_cb(m_fullname, m_funcid) ;
+  if (!function_start_cb || !sample(function))
+    return;
+
+  // Whether the call is traced is only known once it ends
+  static const uint64_t min_duration_ns =
+    static_cast<uint64_t>(xrt_core::config::get_native_xrt_trace_min_duration_us()) * 1000;
+  if (min_duration_ns && function_complete_cb) {
+    m_deferred = true;
+    m_start = static_cast<uint64_t>(xrt_core::time_ns());
+    return;
   }
+
+  m_traced = true;
+  m_funcid = xrt_core::utils::issue_id() ;
+  function_start_cb(m_fullname, m_funcid) ;
 }
 
 generic_api_call_logger::
 ~generic_api_call_logger()
 {
-  if (function_end_cb) {
+  static const uint64_t min_duration_ns =
+    static_cast<uint64_t>(xrt_core::config::get_native_xrt_trace_min_duration_us()) * 1000;
+
+  if (m_deferred) {
     auto timestamp = static_cast<uint64_t>(xrt_core::time_ns());
-    function_end_cb(m_fullname, m_funcid, timestamp) ;
+    if (timestamp - m_start >= min_duration_ns)
+      function_complete_cb(m_fullname, xrt_core::utils::issue_id(), m_start, timestamp) ;
+    return;
   }
+
+  // Calls that are not traced are not timed
+  if (m_traced && function_end_cb)
+    function_end_cb(m_fullname, m_funcid, static_cast<uint64_t>(xrt_core::time_ns())) ;
 }
 
 sync_logger::
@@ -111,5 +250,12 @@ sync_logger::
   }
 }
 
+void
+log_copy_path(const char* path, size_t size)
+{
+  if (copy_path_cb)
+    copy_path_cb(path, static_cast<uint64_t>(size));
+}
+
 } // end namespace xdp::native
 
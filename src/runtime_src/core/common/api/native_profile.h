@@ -34,8 +34,19 @@ class api_call_logger
   virtual ~api_call_logger() = default ;
 } ;
 
+// Native API calls can be sampled and filtered with xrt.ini settings
+// (native_xrt_trace_sample_rate, native_xrt_trace_min_duration_us and
+// native_xrt_trace_functions).  Calls that are not traced never reach
+// the plugin.
 class generic_api_call_logger : public api_call_logger
 {
+  bool m_traced = false ;
+
+  // Set when the call is only traced if it is slow enough, in which
+  // case the whole call is reported when it ends
+  bool m_deferred = false ;
+  uint64_t m_start = 0 ;
+
   generic_api_call_logger() = delete ;
   generic_api_call_logger(const generic_api_call_logger&) = delete ;
   generic_api_call_logger(generic_api_call_logger&&) = delete ;
@@ -89,6 +100,11 @@ profiling_wrapper_sync(const char* function, xclBOSyncDirection dir, size_t size
   return f(std::forward<Args>(args)...) ;
 }
 
+// Count a buffer to buffer copy of size bytes done using the
+// specified copy path.  No-op unless the plugin is loaded.
+void
+log_copy_path(const char* path, size_t size);
+
 } // end namespace xdp::native
 
 #endif
@@ -26,6 +26,7 @@
 #include "core/common/message.h"
 #include "core/common/query_requests.h"
 #include "core/common/system.h"
+#include "core/common/task.h"
 #include "core/common/trace.h"
 #include "core/common/unistd.h"
 #include "core/common/xclbin_parser.h"
@@ -33,10 +34,18 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/shared_handle.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <future>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -110,6 +119,51 @@ send_exception_message(const std::string& msg)
   send_exception_message(msg.c_str());
 }
 
+// class copy_workers - threads for pipelined copies through host
+//
+// Created with the first copy that is pipelined in chunks and kept
+// for the lifetime of the process.  A pipelined copy runs a sync from
+// device, a sync to device, and copy_threads-1 parts of the host copy
+// concurrently with the host copy part done by the calling thread.
+// Tasks never wait for other tasks, so concurrent copies sharing the
+// workers just queue up.
+class copy_workers
+{
+  xrt_core::task::queue m_queue;
+  std::vector<std::thread> m_threads;
+
+public:
+  explicit copy_workers(size_t threads)
+  {
+    for (size_t idx = 0; idx < threads; ++idx)
+      m_threads.emplace_back(xrt_core::task::worker, std::ref(m_queue));
+  }
+
+  ~copy_workers()
+  {
+    m_queue.stop();
+    for (auto& thread : m_threads)
+      thread.join();
+  }
+
+  copy_workers(const copy_workers&) = delete;
+  copy_workers& operator=(const copy_workers&) = delete;
+
+  template <typename Function>
+  auto
+  run(Function&& fcn)
+  {
+    return xrt_core::task::createF(m_queue, std::forward<Function>(fcn));
+  }
+
+  static copy_workers&
+  instance()
+  {
+    static copy_workers workers(std::max(xrt_core::config::get_copy_threads(), 1U) + 1);
+    return workers;
+  }
+};
+
 } // namespace
 
 namespace {
@@ -168,6 +222,86 @@ public:
   }
 };
 
+// class copy_strategy - Buffer to buffer copy path of a device
+//
+// Whether a device supports m2m does not change while the device is
+// open, so the capability is resolved once per device rather than
+// queried for every copy.  KDMA is used only if enabled in xrt.ini,
+// and is abandoned for the device the first time it fails.
+class copy_strategy
+{
+  bool m_m2m;
+  std::atomic<bool> m_kdma;
+
+  static bool
+  query_m2m(const xrt_core::device* device)
+  {
+    try {
+      auto m2m = xrt_core::device_query<xrt_core::query::m2m>(device);
+      return xrt_core::query::m2m::to_bool(m2m);
+    }
+    catch (const std::exception&) {
+      return false;
+    }
+  }
+
+public:
+  explicit copy_strategy(const xrt_core::device* device)
+    : m_m2m(query_m2m(device))
+    , m_kdma(xrt_core::config::get_cdma())
+  {}
+
+  // Get the copy strategy of a device, construct on first use.
+  //
+  // Entries refer to their device weakly.  Entries of devices that
+  // have been closed are pruned when a strategy is constructed, so
+  // stale entries do not accumulate as devices are opened and closed.
+  static std::shared_ptr<copy_strategy>
+  get(const std::shared_ptr<xrt_core::device>& device)
+  {
+    using entry = std::pair<std::weak_ptr<xrt_core::device>, std::shared_ptr<copy_strategy>>;
+    static std::mutex mutex;
+    static std::map<const xrt_core::device*, entry> strategies;
+    std::lock_guard lk(mutex);
+    if (auto itr = strategies.find(device.get()); itr != strategies.end()) {
+      const auto& [dev, strategy] = itr->second;
+      if (dev.lock() == device)
+        return strategy;
+    }
+
+    for (auto itr = strategies.begin(); itr != strategies.end();)
+      itr = itr->second.first.expired() ? strategies.erase(itr) : std::next(itr);
+
+    // Device object is new or has been recycled at same address
+    auto& [dev, strategy] = strategies[device.get()];
+    dev = device;
+    strategy = std::make_shared<copy_strategy>(device.get());
+    return strategy;
+  }
+
+  [[nodiscard]] bool
+  m2m() const
+  {
+    return m_m2m;
+  }
+
+  [[nodiscard]] bool
+  kdma() const
+  {
+    return m_kdma;
+  }
+
+  void
+  disable_kdma(const char* reason)
+  {
+    if (!m_kdma.exchange(false))
+      return;
+
+    auto fmt = boost::format("Reverting to host copy of buffers (%s)") % reason;
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",  fmt.str());
+  }
+};
+
 } // namespace
 
 namespace xrt {
@@ -365,38 +499,42 @@ public:
       return;
     }
 
+    auto strategy = copy_strategy::get(get_device());
+
     // try copying with m2m
-    try {
-      auto m2m = xrt_core::device_query<xrt_core::query::m2m>(get_device());
-      if (xrt_core::query::m2m::to_bool(m2m)) {
+    if (strategy->m2m()) {
+      try {
         handle->copy(src->handle.get(), sz, dst_offset, src_offset);
+        xdp::native::log_copy_path("m2m", sz);
         return;
       }
-    }
-    catch (const std::exception&) {
+      catch (const std::exception&) {
+      }
     }
 
     // try copying with kdma
-    try {
-      if (xrt_core::config::get_cdma()) {
+    if (strategy->kdma()) {
+      try {
         xrt_core::kernel_int::copy_bo_with_kdma
           (get_device(), sz, handle.get(), dst_offset, src->handle.get(), src_offset);
+        xdp::native::log_copy_path("kdma", sz);
         return;
       }
-    }
-    catch (const std::exception& ex) {
-      auto fmt = boost::format("Reverting to host copy of buffers (%s)") % ex.what();
-      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",  fmt.str());
+      catch (const std::exception& ex) {
+        strategy->disable_kdma(ex.what());
+      }
     }
 
     // special case sw emulation on imported buffers
     if (is_sw_emulation() && (is_imported() || src->is_imported())) {
       handle->copy(src->handle.get(), sz, dst_offset, src_offset);
+      xdp::native::log_copy_path("sw_emu import", sz);
       return;
     }
 
     // revert to copying through host
     copy_through_host(src, sz, src_offset, dst_offset);
+    xdp::native::log_copy_path("host", sz);
   }
 
   void
@@ -419,17 +557,92 @@ public:
     if (!dst_hbuf)
       throw xrt_core::system_error(EINVAL, "No host side buffer in destination buffer");
 
-    // sync to src to ensure data integrity, logically const
+    static const size_t chunk_size = std::max<size_t>(xrt_core::config::get_copy_chunk_size(), 4096);
+    if (sz <= chunk_size) {
+      // sync to src to ensure data integrity, logically const
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // special case
+      const_cast<bo_impl*>(src)->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
+
+      // copy host side buffer
+      std::memcpy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+
+      // sync modified host buffer to device
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+      return;
+    }
+
+    // Pipeline the copy in chunks. While a chunk is copied on host,
+    // the next chunk is synced from device and the previous chunk is
+    // synced to device.
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // special case
-    const_cast<bo_impl*>(src)->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
+    auto src_bo = const_cast<bo_impl*>(src);
+    auto sync_in = [src_bo, src_offset, sz](size_t off) {
+      src_bo->sync(XCL_BO_SYNC_BO_FROM_DEVICE, std::min(chunk_size, sz - off), src_offset + off);
+    };
+    auto sync_out = [this, dst_offset, sz](size_t off) {
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, std::min(chunk_size, sz - off), dst_offset + off);
+    };
+
+    auto& workers = copy_workers::instance();
+    std::optional<xrt_core::task::event<void>> in;
+    std::optional<xrt_core::task::event<void>> out;
+    sync_in(0);
+    try {
+      for (size_t off = 0; off < sz; off += chunk_size) {
+        auto next = off + chunk_size;
+        if (next < sz)
+          in.emplace(workers.run([sync_in, next] { sync_in(next); }));
 
-    // copy host side buffer
-    std::memcpy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+        copy_chunk(workers, dst_hbuf + dst_offset + off, src_hbuf + src_offset + off, std::min(chunk_size, sz - off));
 
-    // sync modified host buffer to device
-    sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+        if (out)
+          out->get();
+        out.emplace(workers.run([sync_out, off] { sync_out(off); }));
+
+        if (in) {
+          in->get();
+          in.reset();
+        }
+      }
+      out->get();
+    }
+    catch (...) {
+      // Outstanding syncs refer to the buffers, wait before unwinding
+      for (auto event : {&in, &out}) {
+        try {
+          if (*event)
+            (*event)->wait();
+        }
+        catch (...) {
+        }
+      }
+      throw;
+    }
   }
 
+  // Host copy of a chunk, split across copy threads
+  static void
+  copy_chunk(copy_workers& workers, char* dst, const char* src, size_t sz)
+  {
+    static const size_t threads = std::max(xrt_core::config::get_copy_threads(), 1U);
+    auto part = (sz + threads - 1) / threads;
+    std::vector<xrt_core::task::event<void>> parts;
+    for (size_t off = part; off < sz; off += part)
+      parts.push_back(workers.run([dst, src, off, part, sz] {
+        std::memcpy(dst + off, src + off, std::min(part, sz - off));
+      }));
+
+    std::memcpy(dst, src, std::min(part, sz));
+    for (auto& p : parts)
+      p.get();
+  }
+
+  // Copy asynchronously, the returned handle waits for the copy to
+  // complete.  The source and destination buffers are kept alive by
+  // the handle until the copy has completed.
+  xrt::bo::async_handle
+  async_copy(xrt::bo& bo, const xrt::bo& src, size_t sz, size_t src_offset, size_t dst_offset);
+
   void
   sync(xrt::bo& bo, const std::string& port, xclBOSyncDirection dir, size_t sz, size_t offset)
   {
@@ -461,6 +674,49 @@ public:
     m_usage_logger->log_buffer_sync(device->get_device_id(), device.get_hwctx_handle(), sz, dir);
   }
 
+  // Sync list of ranges sorted by offset with no overlap
+  virtual void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges)
+  {
+    size_t total = 0;
+    for (const auto& range : ranges)
+      total += range.second;
+
+    handle->sync_ranges(static_cast<xrt_core::buffer_handle::direction>(dir), ranges);
+    m_usage_logger->log_buffer_sync(device->get_device_id(), device.get_hwctx_handle(), total, dir);
+  }
+
+  // Validate and coalesce (offset, size) ranges then sync the
+  // resulting ranges in one call
+  void
+  sync(xclBOSyncDirection dir, std::vector<xrt_core::buffer_handle::range> ranges)
+  {
+    for (auto [offset, sz] : ranges)
+      if (sz > size || offset > size - sz)
+        throw xrt_core::system_error(EINVAL, "sync range past buffer size");
+
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<xrt_core::buffer_handle::range> merged;
+    for (auto [offset, sz] : ranges) {
+      if (!sz)
+        continue;
+
+      // Extend previous range if overlapping or adjacent
+      if (!merged.empty() && offset <= merged.back().first + merged.back().second) {
+        auto& [last_offset, last_sz] = merged.back();
+        last_sz = std::max(last_offset + last_sz, offset + sz) - last_offset;
+        continue;
+      }
+
+      merged.emplace_back(offset, sz);
+    }
+
+    if (merged.size() == 1)
+      sync(dir, merged.front().second, merged.front().first);
+    else if (!merged.empty())
+      sync_ranges(dir, merged);
+  }
+
   virtual uint64_t
   get_address() const
   {
@@ -608,6 +864,52 @@ public:
 // Initialize static data member for async info
 aie::bo::async_handle_impl::handle_map aie::bo::async_handle_impl::async_info;
 
+// class copy_async_handle_impl - Asynchronous copy of buffer content
+//
+// The copy is performed by a separate thread.  Waiting for the copy
+// rethrows any exception from the copy.
+class copy_async_handle_impl : public xrt::bo::async_handle_impl
+{
+  xrt::bo m_src;
+  std::future<void> m_copy;
+
+public:
+  copy_async_handle_impl(xrt::bo bo, xrt::bo src, size_t sz, size_t src_offset, size_t dst_offset)
+    : xrt::bo::async_handle_impl(std::move(bo))
+    , m_src(std::move(src))
+  {
+    m_copy = std::async(std::launch::async, [this, sz, src_offset, dst_offset] {
+      m_bo.get_handle()->copy(m_src.get_handle().get(), sz, src_offset, dst_offset);
+    });
+  }
+
+  ~copy_async_handle_impl() override
+  {
+    // Destruction of the future blocks until the copy completes
+    if (m_copy.valid())
+      m_copy.wait();
+  }
+
+  copy_async_handle_impl(const copy_async_handle_impl&) = delete;
+  copy_async_handle_impl(copy_async_handle_impl&&) = delete;
+  copy_async_handle_impl& operator=(const copy_async_handle_impl&) = delete;
+  copy_async_handle_impl& operator=(copy_async_handle_impl&&) = delete;
+
+  void
+  wait() override
+  {
+    if (m_copy.valid())
+      m_copy.get();
+  }
+};
+
+xrt::bo::async_handle
+bo_impl::
+async_copy(xrt::bo& bo, const xrt::bo& src, size_t sz, size_t src_offset, size_t dst_offset)
+{
+  return xrt::bo::async_handle{std::make_shared<copy_async_handle_impl>(bo, src, sz, src_offset, dst_offset)};
+}
+
 xrt::bo::async_handle
 bo_impl::
 async(xrt::bo& bo, const std::string& port, xclBOSyncDirection dir, size_t sz, size_t offset)
@@ -869,6 +1171,13 @@ public:
     }
   }
 
+  void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges) override
+  {
+    for (auto [offset, sz] : ranges)
+      sync(dir, sz, offset);
+  }
+
   void
   copy(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset) override
   {
@@ -935,6 +1244,17 @@ public:
     // sync through parent buffer, which handles nodma case also
     m_parent->sync(dir, sz, off);
   }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges) override
+  {
+    // ranges are validated against sub buffer size, adjust to parent
+    auto parent_ranges = ranges;
+    for (auto& range : parent_ranges)
+      range.first += m_offset;
+
+    m_parent->sync_ranges(dir, parent_ranges);
+  }
 };
 
 // class buffer_xbuf - Wrapper for extern managed xclBufferHandle
@@ -970,6 +1290,12 @@ public:
     throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
   }
 
+  void
+  sync_ranges(xclBOSyncDirection, const std::vector<xrt_core::buffer_handle::range>&) override
+  {
+    throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
+  }
+
   bool
   is_sub() const override
   {
@@ -1502,6 +1828,52 @@ sync(xclBOSyncDirection dir, size_t size, size_t offset)
     });
 }
 
+void
+bo::
+sync(xclBOSyncDirection dir, const std::vector<std::pair<size_t, size_t>>& ranges)
+{
+  size_t total = 0;
+  for (const auto& range : ranges)
+    total += range.second;
+
+  return xdp::native::profiling_wrapper_sync("xrt::bo::sync", dir, total,
+    [this, dir, &ranges]{
+      handle->sync(dir, ranges);
+    });
+}
+
+void
+bo::
+sync_2d(xclBOSyncDirection dir, size_t width, size_t height, size_t stride, size_t offset)
+{
+  if (width > stride)
+    throw xrt_core::system_error(EINVAL, "sync width larger than stride");
+
+  if (!width || !height)
+    return;
+
+  // Extent of the window from first byte of first row to last byte
+  // of last row must be within the buffer, checked without overflow
+  if (height - 1 > (std::numeric_limits<size_t>::max() - width) / stride)
+    throw xrt_core::system_error(EINVAL, "sync window size overflows");
+
+  auto extent = (height - 1) * stride + width;
+  auto bo_size = handle->get_size();
+  if (extent > bo_size || offset > bo_size - extent)
+    throw xrt_core::system_error(EINVAL, "sync window past buffer size");
+
+  // Rows are adjacent if width equals stride, sync as one range
+  if (width == stride)
+    return sync(dir, width * height, offset);
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  ranges.reserve(height);
+  for (size_t row = 0; row < height; ++row)
+    ranges.emplace_back(offset + row * stride, width);
+
+  sync(dir, ranges);
+}
+
 bo::async_handle
 bo::
 async(xclBOSyncDirection dir, size_t sz, size_t offset)
@@ -1546,6 +1918,16 @@ copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
     });
 }
 
+bo::async_handle
+bo::
+async_copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
+{
+  return xdp::native::profiling_wrapper("xrt::bo::async_copy",
+    [this, &src, sz, src_offset, dst_offset]{
+      return handle->async_copy(*this, src, sz, src_offset, dst_offset);
+    });
+}
+
 bo::
 ~bo()
 {}
@@ -63,6 +63,7 @@
 #include <stdexcept>
 #include <fstream>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 using namespace std::chrono_literals;
 
@@ -351,11 +352,9 @@ cu_access_mode(xrt::hw_context::access_mode mode)
 struct device_type
 {
   std::shared_ptr<xrt_core::device> core_device;
-  xrt_core::bo_cache exec_buffer_cache;
+  std::shared_ptr<xrt_core::bo_pool> exec_buffer_pool;
   uint32_t uid; // internal unique id for debug
 
-  static constexpr unsigned int cache_size = 128;
-
   static uint32_t
   create_uid()
   {
@@ -366,7 +365,7 @@ struct device_type
   explicit
   device_type(xrtDeviceHandle dhdl)
     : core_device(xrt_core::device_int::get_core_device(dhdl))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_pool(xrt_core::bo_pool::get(core_device, xrt_core::config::get_exec_bo_pool_size()))
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
@@ -375,7 +374,7 @@ struct device_type
   explicit
   device_type(std::shared_ptr<xrt_core::device> cdev)
     : core_device(std::move(cdev))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_pool(xrt_core::bo_pool::get(core_device, xrt_core::config::get_exec_bo_pool_size()))
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
@@ -393,10 +392,17 @@ struct device_type
   device_type& operator=(device_type&&) = delete;
 
   template <typename CommandType>
-  xrt_core::bo_cache::cmd_bo<CommandType>
+  xrt_core::bo_pool::cmd_bo<CommandType>
   create_exec_buf()
   {
-    return exec_buffer_cache.alloc<CommandType>();
+    return exec_buffer_pool->alloc<CommandType>();
+  }
+
+  template <typename CommandType>
+  void
+  release_exec_buf(xrt_core::bo_pool::cmd_bo<CommandType>&& execbuf)
+  {
+    exec_buffer_pool->release(std::move(execbuf));
   }
 
   [[nodiscard]] xrt_core::device*
@@ -686,7 +692,7 @@ private:
 class kernel_command : public xrt_core::command
 {
 public:
-  using execbuf_type = xrt_core::bo_cache::cmd_bo<ert_start_kernel_cmd>;
+  using execbuf_type = xrt_core::bo_pool::cmd_bo<ert_start_kernel_cmd>;
   using callback_function_type = std::function<void(ert_cmd_state)>;
   using callback_list = std::vector<callback_function_type>;
 
@@ -719,8 +725,8 @@ public:
   ~kernel_command() override
   {
     XRT_DEBUGF("kernel_command::~kernel_command(%d)\n", m_uid);
-    // This is problematic, bo_cache should return managed BOs
-    m_device->exec_buffer_cache.release(std::move(m_execbuf));
+    // This is problematic, bo_pool should return managed BOs
+    m_device->release_exec_buf(std::move(m_execbuf));
   }
 
   kernel_command(const kernel_command&) = delete;
@@ -851,23 +857,57 @@ public:
       (*cb)(state);
   }
 
-  // Submit the command for execution.
+  // Mark the command as launched in preparation for submission.
+  // Returns true if the command execution is managed.
+  bool
+  prep_run()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw std::runtime_error("bad command state, can't launch");
+    m_managed = (m_callbacks && !m_callbacks->empty());
+    m_done = false;
+    return m_managed;
+  }
+
+  // Returns true if the command would be managed if launched now
+  bool
+  is_managed() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_callbacks && !m_callbacks->empty();
+  }
+
+  // Undo prep_run() for a command that was not submitted.  The
+  // command is marked aborted and done such that it can be waited
+  // on and launched again.
   void
-  run()
+  unprep_run()
   {
     {
       std::lock_guard<std::mutex> lk(m_mutex);
-      if (!m_done)
-        throw std::runtime_error("bad command state, can't launch");
-      m_managed = (m_callbacks && !m_callbacks->empty());
-      m_done = false;
+      get_ert_packet()->state = ERT_CMD_STATE_ABORT;
+      m_done = true;
     }
-    if (m_managed)
+    m_exec_done.notify_all();
+  }
+
+  // Submit the command for execution.
+  void
+  run()
+  {
+    if (prep_run())
       m_hwqueue.managed_start(this);
     else
       m_hwqueue.unmanaged_start(this);
   }
 
+  [[nodiscard]] const xrt_core::hw_queue&
+  get_hw_queue() const
+  {
+    return m_hwqueue;
+  }
+
   // Wait for command completion
   ert_cmd_state
   wait() const
@@ -930,6 +970,39 @@ public:
       : nullptr;
   }
 
+  // Commands targeting one and the same compute unit within a hw
+  // context complete in submission order.  The lane key combines the
+  // hw context with the index of the compute unit.  Commands that can
+  // run on any of several CUs, and non CU commands (copy, abort),
+  // use the default unordered lane.
+  uint64_t
+  get_completion_lane() const override
+  {
+    auto kcmd = get_ert_cmd<const ert_start_kernel_cmd*>();
+    if (kcmd->type != ERT_CU)
+      return xrt_core::command::get_completion_lane();
+
+    size_t count = 0;
+    size_t cuidx = 0;
+    for (uint32_t i = 0; i <= kcmd->extra_cu_masks; ++i) {
+      auto mask = std::bitset<cus_per_word>((i == 0) ? kcmd->cu_mask : kcmd->data[i - 1]);
+      if (mask.none())
+        continue;
+      count += mask.count();
+      for (size_t bit = 0; bit < cus_per_word; ++bit)
+        if (mask.test(bit))
+          cuidx = i * cus_per_word + bit;
+    }
+
+    if (count != 1)
+      return xrt_core::command::get_completion_lane();
+
+    // An odd key never collides with no_lane. cuidx < max_cus fits
+    // in 7 bits.
+    auto hwctx = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(get_hwctx_handle()));
+    return (hwctx << 8) | (cuidx << 1) | 1;
+  }
+
   void
   notify(ert_cmd_state s) const override
   {
@@ -2370,9 +2443,25 @@ public:
     XRT_DEBUG_CALL(debug_cmd_packet(kernel->get_name(), pkt));
   }
 
-  // start() - start the run object (execbuf)
+  // check_submit() - check that the run object can be submitted
+  //
+  // Used by batch start to validate all run objects before any
+  // run object is modified.
+  void
+  check_submit() const
+  {
+    if (m_runlist)
+      throw xrt_core::error("Run object belongs to a runlist and cannot be explicitly started");
+
+    if (!cmd->is_done())
+      throw xrt_core::error(std::errc::device_or_resource_busy, "Run object is still running, can't launch");
+  }
+
+  // prep_submit() - prepare the run object for submission
+  //
+  // Used by start() and by batch start of multiple run objects
   virtual void
-  start()
+  prep_submit()
   {
     if (m_runlist)
       throw xrt_core::error("Run object belongs to a runlist and cannot be explicitly started");
@@ -2385,6 +2474,13 @@ public:
     // constructing args in place
     // sending state as ERT_CMD_STATE_NEW for kernel start
     m_usage_logger->log_kernel_run_info(kernel.get(), this, ERT_CMD_STATE_NEW);
+  }
+
+  // start() - start the run object (execbuf)
+  void
+  start()
+  {
+    prep_submit();
     cmd->run();
   }
 
@@ -2771,7 +2867,7 @@ public:
   }
 
   void
-  start() override
+  prep_submit() override
   {
     // sync command payload to mailbox if necessary
     write();
@@ -2782,7 +2878,7 @@ public:
     pkt->count = kernel->get_num_cumasks() + ap_ctrl_reserved;
 
     // Regular start
-    run_impl::start();
+    run_impl::prep_submit();
   }
 };
 
@@ -2906,6 +3002,13 @@ public:
 // submissions of chained ert commands.  The size
 // of a chain is currently hardwired, but at some
 // point will be dyanmic.
+//
+// The chained commands are built once as run objects and fence
+// waits or signals are added to the list.  Executing the list
+// replays the chained commands and fences in the order in which
+// they were added, arguments of run objects can be changed between
+// executions.  A fence always ends the current chain, the next run
+// object added starts a new chain.
 class runlist_impl
 {
   static constexpr size_t submit_size = 24;
@@ -2914,10 +3017,12 @@ class runlist_impl
   static constexpr size_t word_size = sizeof(uint32_t); // ert payload word size
 
   // The runlist creates its own execution buffers, which are
-  // ert_packets with payload interpreted as ert_cmd_chain_data
+  // ert_packets with payload interpreted as ert_cmd_chain_data.
+  // The execution buffers are drawn from the device command BO
+  // pool and returned to the pool when the runlist is destroyed.
   using cmd_type = ert_packet;
-  using execbuf_type = xrt_core::bo_cache::cmd_bo<cmd_type>;
-  xrt_core::bo_cache_t<execbuf_size> m_exec_buffer_cache;
+  using execbuf_type = xrt_core::bo_pool::cmd_bo<cmd_type>;
+  std::shared_ptr<xrt_core::bo_pool> m_exec_buffer_pool;
 
   enum class state { idle, closed, running, error };
   mutable state m_state = state::idle;
@@ -2936,6 +3041,18 @@ class runlist_impl
   std::vector<execbuf_type> m_cmds;
   std::vector<execbuf_type*> m_submitted_cmds;
 
+  // Fence waits and signals are submitted to the hw queue before
+  // the chained command at index 'cmdidx' in m_cmds.  A fence with
+  // cmdidx equal to number of chained commands is submitted after
+  // the last chained command.
+  struct fence_point
+  {
+    size_t cmdidx;
+    bool signal;
+    xrt::fence fence;
+  };
+  std::vector<fence_point> m_fences;
+
   static const std::string&
   state_to_string(state st)
   {
@@ -2961,12 +3078,12 @@ class runlist_impl
   }
 
   // Execution buffers are cached and reused within this runlist
-  // This function creates or gets an execbuf from the cache
-  // and initializes the command in prep for add chained commands.
+  // This function gets an execbuf from the device pool and
+  // initializes the command in prep for add chained commands.
   execbuf_type
   create_exec_buf()
   {
-    auto execbuf = m_exec_buffer_cache.alloc<cmd_type>();
+    auto execbuf = m_exec_buffer_pool->alloc<cmd_type>(execbuf_size);
     auto pkt = execbuf.second;
     pkt->opcode = ERT_CMD_CHAIN;
     pkt->count = sizeof(ert_cmd_chain_data) / word_size;  // payload size in words
@@ -2977,17 +3094,55 @@ class runlist_impl
 
   // The chained command execbufs are created as needed
   // when commands are added to the runlist.  Here we
-  // get the cmd that chains the run at specified index.
+  // get the cmd that chains the next run added.  A new
+  // chain is started if the current chain is full or if
+  // a fence was added after the current chain.
   execbuf_type*
-  get_cmd_chain_for_run_at_index(size_t runidx)
+  get_cmd_chain_for_next_run()
   {
-    auto idx = runidx / submit_size;
-    if (idx < m_cmds.size())
-      return &m_cmds[idx];
+    if (!m_cmds.empty()
+        && get_ert_cmd_chain_data(m_cmds.back().second)->command_count < submit_size
+        && (m_fences.empty() || m_fences.back().cmdidx < m_cmds.size()))
+      return &m_cmds.back();
 
     m_cmds.push_back(create_exec_buf());
     m_submitted_cmds.reserve(m_cmds.size());
-    return &m_cmds.at(idx);
+    return &m_cmds.back();
+  }
+
+  // Submit fences recorded before chained command at index
+  void
+  submit_fences(size_t cmdidx)
+  {
+    for (const auto& fp : m_fences) {
+      if (fp.cmdidx != cmdidx)
+        continue;
+
+      if (fp.signal)
+        m_hwqueue.submit_signal(fp.fence);
+      else
+        m_hwqueue.submit_wait(fp.fence);
+    }
+  }
+
+  void
+  add_fence(const xrt::fence& fence, bool signal)
+  {
+    if (m_state != state::idle)
+      throw xrt_core::error("runlist must be idle before adding fences, current state: " + state_to_string(m_state));
+
+    m_fences.push_back({m_cmds.size(), signal, fence});
+  }
+
+  // Return execution buffers to the device pool.  Must not
+  // be called while the runlist is running.
+  void
+  release_exec_bufs()
+  {
+    m_submitted_cmds.clear();
+    for (auto& execbuf : m_cmds)
+      m_exec_buffer_pool->release(std::move(execbuf), execbuf_size);
+    m_cmds.clear();
   }
 
   void
@@ -3076,7 +3231,7 @@ class runlist_impl
     for (auto execbuf : m_submitted_cmds) {
       auto state = get_completed_state(execbuf, 1ms);
       if (state == ERT_CMD_STATE_COMPLETED) {
-        runidx += submit_size;
+        runidx += get_ert_cmd_chain_data(execbuf->second)->command_count;
         continue;
       }
 
@@ -3111,11 +3266,16 @@ class runlist_impl
   // successfully submitted command must be waited for before the list
   // can be reset. Pre-condition ensured by execute() is that size of
   // runlist is greater than 0.
+  //
+  // Fences are submitted in between the chained commands per the
+  // order in which they were added to the runlist.
   void
   submit()
   {
     m_submitted_cmds.clear();
-    for (auto& execbuf : m_cmds) {
+    for (size_t idx = 0; idx < m_cmds.size(); ++idx) {
+      submit_fences(idx); // can throw
+      auto& execbuf = m_cmds[idx];
       auto [cmd, pkt] = unpack(execbuf);
       pkt->state = ERT_CMD_STATE_NEW;
       // m_submitted commands reflect what has been successfully
@@ -3124,6 +3284,7 @@ class runlist_impl
       m_hwqueue.submit(cmd); // can throw
       m_submitted_cmds.emplace_back(&execbuf); // no throw reserved size
     }
+    submit_fences(m_cmds.size());
   }
 
 public:
@@ -3137,7 +3298,7 @@ public:
 public:
   explicit
   runlist_impl(xrt::hw_context hwctx)
-    : m_exec_buffer_cache{hwctx.get_device().get_handle(), 128}
+    : m_exec_buffer_pool{xrt_core::bo_pool::get(hwctx.get_device().get_handle(), xrt_core::config::get_exec_bo_pool_size())}
     , m_hwctx{std::move(hwctx)}
     , m_hwqueue{m_hwctx}
   {}
@@ -3151,6 +3312,18 @@ public:
     catch (const std::exception& ex) {
       xrt_core::send_exception_message("runlist clear_runs error: " + std::string(ex.what()));
     }
+
+    // Execution buffers of a running list cannot be reused,
+    // they are destroyed along with the runlist
+    if (m_state == state::running)
+      return;
+
+    try {
+      release_exec_bufs();
+    }
+    catch (const std::exception& ex) {
+      xrt_core::send_exception_message("runlist release error: " + std::string(ex.what()));
+    }
   }
 
   void
@@ -3164,7 +3337,7 @@ public:
     m_runlist.reserve(runidx + 1);
     m_bos.reserve(runidx + 1);
 
-    auto execbuf = get_cmd_chain_for_run_at_index(runidx);
+    auto execbuf = get_cmd_chain_for_next_run();
     auto [cmd, pkt] = unpack(execbuf);
     auto chain_data = get_ert_cmd_chain_data(pkt);
     
@@ -3196,13 +3369,25 @@ public:
     m_bos.push_back(run_bo);              // ptr noexcept
   }
 
+  void
+  submit_wait(const xrt::fence& fence)
+  {
+    add_fence(fence, false);
+  }
+
+  void
+  submit_signal(const xrt::fence& fence)
+  {
+    add_fence(fence, true);
+  }
+
   void
   execute(const xrt::runlist& rl)
   {
     if (m_state != state::idle)
       throw xrt_core::error("runlist must be idle before submitting for execution, current state: " + state_to_string(m_state));
 
-    if (m_runlist.empty())
+    if (m_runlist.empty() && m_fences.empty())
       return;
 
     // Prep each run object
@@ -3296,8 +3481,8 @@ public:
 
     m_runlist.clear();
     m_bos.clear();
-    m_submitted_cmds.clear();
-    m_cmds.clear();
+    m_fences.clear();
+    release_exec_bufs();
     m_state = state::idle;
   }
 };
@@ -3460,6 +3645,77 @@ get_mailbox_impl(const xrt::run& run)
   return mimpl;
 }
 
+// Start a batch of run objects.  The commands are grouped by hw
+// queue and managed execution, and each group is submitted in one
+// call preserving the order of the run objects in the group.
+//
+// All run objects are checked before any is modified, a run object
+// that is still running or appears twice would otherwise fail in
+// prep_run() after earlier run objects were marked as launched.
+//
+// The commands of a group are marked as launched right before the
+// group is submitted.  If submission fails, the commands that were
+// not submitted are marked done again and the exception propagates,
+// commands of later groups are left untouched.
+static void
+start_runs(const std::vector<xrt::run>& runs)
+{
+  struct batch
+  {
+    xrt_core::hw_queue hwqueue;
+    bool managed;
+    std::vector<kernel_command*> cmds;
+  };
+  std::vector<batch> batches;
+
+  std::unordered_set<const xrt::run_impl*> unique;
+  for (const auto& run : runs) {
+    const auto& rimpl = run.get_handle();
+    if (!unique.insert(rimpl.get()).second)
+      throw xrt_core::error(EINVAL, "Run object appears more than once in batch");
+    rimpl->check_submit();
+  }
+
+  // Prepare all run objects before any is launched
+  for (const auto& run : runs)
+    run.get_handle()->prep_submit();
+
+  for (const auto& run : runs) {
+    auto cmd = run.get_handle()->get_cmd();
+    auto managed = cmd->is_managed();
+    const auto& hwqueue = cmd->get_hw_queue();
+    auto itr = std::find_if(batches.begin(), batches.end(),
+                            [&hwqueue, managed](const auto& b) {
+                              return b.managed == managed && b.hwqueue.get_handle() == hwqueue.get_handle();
+                            });
+    if (itr == batches.end())
+      itr = batches.insert(batches.end(), {hwqueue, managed, {}});
+    itr->cmds.push_back(cmd);
+  }
+
+  for (auto& b : batches) {
+    std::vector<xrt_core::command*> cmds;
+    cmds.reserve(b.cmds.size());
+    for (auto cmd : b.cmds) {
+      cmd->prep_run();
+      cmds.push_back(cmd);
+    }
+
+    size_t submitted = 0;
+    try {
+      if (b.managed)
+        b.hwqueue.managed_start(cmds, submitted);
+      else
+        b.hwqueue.unmanaged_start(cmds, submitted);
+    }
+    catch (...) {
+      for (auto itr = b.cmds.begin() + submitted; itr != b.cmds.end(); ++itr)
+        (*itr)->unprep_run();
+      throw;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////
 // Implementation helper for C API
 ////////////////////////////////////////////////////////////////
@@ -3968,6 +4224,20 @@ add(const xrt::run& run)
 }
 
 
+void
+runlist::
+submit_wait(const xrt::fence& fence)
+{
+  handle->submit_wait(fence);
+}
+
+void
+runlist::
+submit_signal(const xrt::fence& fence)
+{
+  handle->submit_signal(fence);
+}
+
 void
 runlist::
 execute()
@@ -4006,6 +4276,16 @@ reset()
   handle->reset();
 }
 
+void
+start(const std::vector<xrt::run>& runs)
+{
+  XRT_TRACE_POINT_SCOPE(xrt_run_start);
+  xdp::native::profiling_wrapper
+    ("xrt::start", [&runs] {
+      start_runs(runs);
+    });
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/common/config_reader.h"
 #include "core/common/message.h"
+#include "core/common/metadata_cache.h"
 #include "experimental/xrt_module.h"
 #include "experimental/xrt_elf.h"
 #include "experimental/xrt_ext.h"
@@ -23,12 +24,14 @@
 #include <elfio/elfio.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <numeric>
 #include <map>
-#include <set>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 
@@ -159,7 +162,7 @@ struct patcher
 // For     *data_to_patch be 0xbb11aaaa and mask be 0x00ff0000
 // To make *data_to_patch be 0xbb55aaaa, register_value must be 0x00550000
   void
-  patch32(uint32_t* data_to_patch, uint64_t register_value, uint32_t mask)
+  patch32(uint32_t* data_to_patch, uint64_t register_value, uint32_t mask) const
   {
     if ((reinterpret_cast<uintptr_t>(data_to_patch) & 0x3) != 0)
       throw std::runtime_error("address is not 4 byte aligned for patch32");
@@ -170,7 +173,7 @@ struct patcher
   }
 
   void
-  patch57(uint32_t* bd_data_ptr, uint64_t patch)
+  patch57(uint32_t* bd_data_ptr, uint64_t patch) const
   {
     uint64_t base_address =
       ((static_cast<uint64_t>(bd_data_ptr[8]) & 0x1FF) << 48) |                       // NOLINT
@@ -184,7 +187,7 @@ struct patcher
   }
 
   void
-  patch57_aie4(uint32_t* bd_data_ptr, uint64_t patch)
+  patch57_aie4(uint32_t* bd_data_ptr, uint64_t patch) const
   {
     uint64_t base_address =
       ((static_cast<uint64_t>(bd_data_ptr[0]) & 0x1FFFFFF) << 32) |                   // NOLINT
@@ -196,7 +199,7 @@ struct patcher
   }
 
   void
-  patch_ctrl48(uint32_t* bd_data_ptr, uint64_t patch)
+  patch_ctrl48(uint32_t* bd_data_ptr, uint64_t patch) const
   {
     // This patching scheme is originated from NPU firmware
     constexpr uint64_t ddr_aie_addr_offset = 0x80000000;
@@ -210,7 +213,7 @@ struct patcher
     bd_data_ptr[3] = (bd_data_ptr[3] & 0xFFFF0000) | (base_address >> 32);            // NOLINT
   }
 
-  void patch_shim48(uint32_t* bd_data_ptr, uint64_t patch)
+  void patch_shim48(uint32_t* bd_data_ptr, uint64_t patch) const
   {
     // This patching scheme is originated from NPU firmware
     constexpr uint64_t ddr_aie_addr_offset = 0x80000000;
@@ -224,8 +227,51 @@ struct patcher
     bd_data_ptr[2] = (bd_data_ptr[2] & 0xFFFF0000) | (base_address >> 32);            // NOLINT
   }
 
+  // Number of bytes modified at each patch offset
+  [[nodiscard]] size_t
+  patch_size() const
+  {
+    switch (m_symbol_type) {
+    case symbol_type::scalar_32bit_kind:
+      return sizeof(uint32_t);
+    case symbol_type::shim_dma_base_addr_symbol_kind:
+      return 9 * sizeof(uint32_t);  // NOLINT bd_data_ptr[0..8]
+    case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
+      return 2 * sizeof(uint32_t);  // bd_data_ptr[0..1]
+    case symbol_type::control_packet_48:
+      return 4 * sizeof(uint32_t);  // bd_data_ptr[0..3]
+    case symbol_type::shim_dma_48:
+      return 3 * sizeof(uint32_t);  // bd_data_ptr[0..2]
+    default:
+      return 0;
+    }
+  }
+
+  // Pages of the buffer modified by patch() as sorted (offset, size)
+  // ranges with adjacent pages merged
+  [[nodiscard]] std::vector<std::pair<size_t, size_t>>
+  patch_pages(size_t page_size) const
+  {
+    std::vector<std::pair<size_t, size_t>> pages;
+    for (const auto& item : m_ctrlcode_patchinfo) {
+      size_t begin = item.offset_to_patch_buffer / page_size * page_size;
+      size_t end = (item.offset_to_patch_buffer + patch_size() + page_size - 1) / page_size * page_size;
+      pages.emplace_back(begin, end - begin);
+    }
+
+    std::sort(pages.begin(), pages.end());
+    std::vector<std::pair<size_t, size_t>> merged;
+    for (const auto& [offset, size] : pages) {
+      if (!merged.empty() && offset <= merged.back().first + merged.back().second)
+        merged.back().second = std::max(merged.back().second, offset + size - merged.back().first);
+      else
+        merged.emplace_back(offset, size);
+    }
+    return merged;
+  }
+
   void
-  patch(uint8_t* base, uint64_t new_value)
+  patch(uint8_t* base, uint64_t new_value) const
   {
     for (auto item : m_ctrlcode_patchinfo) {
       auto bd_data_ptr = reinterpret_cast<uint32_t*>(base + item.offset_to_patch_buffer);
@@ -256,6 +302,49 @@ struct patcher
       }
     }
   }
+
+  // Restore the bits modified by patch() from the original control
+  // code.  Patching adds to the address already in the control code,
+  // so a symbol that is patched again must be patched from its
+  // original value.  original(offset) returns the unpatched control
+  // code at an offset of base.
+  template <typename OriginalFunction>
+  void
+  restore(uint8_t* base, OriginalFunction&& original) const
+  {
+    auto restore_bits = [](uint32_t* dst, const uint32_t* src, size_t word, uint32_t mask) {
+      dst[word] = (dst[word] & ~mask) | (src[word] & mask);
+    };
+
+    for (auto item : m_ctrlcode_patchinfo) {
+      auto dst = reinterpret_cast<uint32_t*>(base + item.offset_to_patch_buffer);
+      auto src = reinterpret_cast<const uint32_t*>(original(item.offset_to_patch_buffer));
+      switch (m_symbol_type) {
+      case symbol_type::scalar_32bit_kind:
+        restore_bits(dst, src, 0, item.mask);
+        break;
+      case symbol_type::shim_dma_base_addr_symbol_kind:
+        restore_bits(dst, src, 1, 0xFFFFFFFF);  // NOLINT
+        restore_bits(dst, src, 2, 0xFFFF);      // NOLINT
+        restore_bits(dst, src, 8, 0x1FF);       // NOLINT
+        break;
+      case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
+        restore_bits(dst, src, 0, 0x1FFFFFF);   // NOLINT
+        restore_bits(dst, src, 1, 0xFFFFFFFF);  // NOLINT
+        break;
+      case symbol_type::control_packet_48:
+        restore_bits(dst, src, 2, 0xFFFFFFFF);  // NOLINT
+        restore_bits(dst, src, 3, 0xFFFF);      // NOLINT
+        break;
+      case symbol_type::shim_dma_48:
+        restore_bits(dst, src, 1, 0xFFFFFFFF);  // NOLINT
+        restore_bits(dst, src, 2, 0xFFFF);      // NOLINT
+        break;
+      default:
+        break;
+      }
+    }
+  }
 };
 
   XRT_CORE_UNUSED void
@@ -276,15 +365,51 @@ struct patcher
     return argument_name + buf_string;
   }
 
+  void
+  log_patch(patcher::buf_type type, const std::string& argnm, size_t index, bool by_index, uint64_t patch)
+  {
+    std::stringstream ss;
+    ss << "Patched " << patcher::section_name_to_string(type);
+    if (by_index)
+      ss << " using argument index " << index;
+    else
+      ss << " using argument name " << argnm;
+    ss << " with value " << std::hex << patch;
+    xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+  }
+
 } // namespace
 
 namespace xrt
 {
 
+// struct shared_ctrlcode - Control code buffer objects shared by the
+// module_sram instances created from one module for one hardware
+// context.  Only buffers that no argument is patched into are shared,
+// they are not modified after creation.
+struct shared_ctrlcode
+{
+  xrt::bo instr;    // Aie2p instruction buffer or Aie2ps column ctrlcodes
+  xrt::bo ctrlpkt;  // Aie2p control packet
+};
+
 // class module_impl - Base class for different implementations
 class module_impl
 {
   xrt::uuid m_cfg_uuid;   // matching hw configuration id
+
+  // Control code shared by module_sram instances created from this
+  // module, one entry per hardware context.  The entries do not own
+  // the hardware context or the control code, the buffer objects are
+  // released with the last module_sram using them.
+  struct shared_ctrlcode_entry
+  {
+    std::weak_ptr<xrt::hw_context_impl> hwctx;
+    std::weak_ptr<shared_ctrlcode> ctrlcode;
+  };
+  std::mutex m_shared_mutex;
+  std::vector<shared_ctrlcode_entry> m_shared_ctrlcode;
+
 public:
   explicit module_impl(xrt::uuid cfg_uuid)
     : m_cfg_uuid(std::move(cfg_uuid))
@@ -423,6 +548,19 @@ public:
     throw std::runtime_error("Not supported");
   }
 
+  // Get the patcher for an argument
+  //
+  // @param argname - argument name
+  // @param index - argument index, used if there is no patcher for the name
+  // @param buf_type - whether it is control-code, control-packet, preempt-save or preempt-restore
+  // @param by_index - set to true if the patcher was found by index
+  // @Return patcher for the argument, nullptr if the argument is not patched
+  [[nodiscard]] virtual const patcher*
+  get_patcher(const std::string&, size_t, patcher::buf_type, bool&) const
+  {
+    throw std::runtime_error("Not supported");
+  }
+
   // Get the number of patchers for arguments.  The returned
   // value is the number of arguments that must be patched before
   // the control code can be executed.
@@ -432,6 +570,42 @@ public:
     return 0;
   }
 
+  // Check if any argument is patched into a buffer type.  The control
+  // packet address patched into the instruction buffer is not an
+  // argument.
+  [[nodiscard]] virtual bool
+  has_arg_patchers(patcher::buf_type) const
+  {
+    return true;
+  }
+
+  // Get the control code shared by module_sram instances created
+  // from this module for a hardware context.  If none is in use, it
+  // is made with create().
+  template <typename CreateFunction>
+  std::shared_ptr<shared_ctrlcode>
+  get_shared_ctrlcode(const xrt::hw_context& hwctx, CreateFunction&& create)
+  {
+    const auto& handle = hwctx.get_handle();
+    std::lock_guard lk(m_shared_mutex);
+    for (const auto& entry : m_shared_ctrlcode) {
+      if (entry.hwctx.lock() != handle)
+        continue;
+      if (auto shared = entry.ctrlcode.lock())
+        return shared;
+    }
+
+    // Remove entries no longer in use
+    m_shared_ctrlcode.erase
+      (std::remove_if(m_shared_ctrlcode.begin(), m_shared_ctrlcode.end(),
+                      [](const auto& entry) { return entry.hwctx.expired() || entry.ctrlcode.expired(); }),
+       m_shared_ctrlcode.end());
+
+    auto shared = create();
+    m_shared_ctrlcode.push_back({ handle, shared });
+    return shared;
+  }
+
   // Check that all arguments have been patched and sync control code
   // buffer if necessary.  Throw if not all arguments have been patched.
   virtual void
@@ -783,33 +957,148 @@ class module_elf : public module_impl
     return arg2patcher;
   }
 
-  bool
-  patch(uint8_t* base, const std::string& argnm, size_t index, uint64_t patch, patcher::buf_type type) override
+  // Increment when the serialized argument patchers change
+  static constexpr uint32_t arg_patchers_version = 1;
+
+  // Hash of the ELF data the argument patchers are created from, used
+  // with the cfg uuid as the metadata cache key.  The patchers depend
+  // on the section names and sizes and on the contents of the
+  // relocation and dynamic symbol sections only, the control code
+  // itself, which is most of the ELF, is not hashed.
+  static uint64_t
+  hash_sections(const ELFIO::elfio& elf)
   {
-    const std::string key_string = generate_key_string(argnm, type);
-    auto it = m_arg2patcher.find(key_string);
-    auto not_found_use_argument_name = (it == m_arg2patcher.end());
-    if (not_found_use_argument_name) {// Search using index
-      auto index_string = std::to_string(index);
-      const std::string key_index_string = generate_key_string(index_string, type);
-      it = m_arg2patcher.find(key_index_string);
-      if (it == m_arg2patcher.end())
-        return false;
+    auto os_abi = elf.get_os_abi();
+    auto hash = xrt_core::metadata_cache::hash(&os_abi, sizeof(os_abi));
+    for (const auto& sec : elf.sections) {
+      auto name = sec->get_name();
+      uint64_t size = sec->get_size();
+      hash = xrt_core::metadata_cache::hash(name.data(), name.size(), hash);
+      hash = xrt_core::metadata_cache::hash(&size, sizeof(size), hash);
+      bool patcher_data = name.find(".rela.dyn") != std::string::npos || name == ".dynsym" || name == ".dynstr";
+      if (patcher_data && sec->get_data())
+        hash = xrt_core::metadata_cache::hash(sec->get_data(), size, hash);
+    }
+    return hash;
+  }
+
+  [[nodiscard]] std::vector<char>
+  serialize_arg_patchers() const
+  {
+    xrt_core::metadata_cache::writer out;
+    out.write(arg_patchers_version);
+    out.write<uint64_t>(m_scratch_pad_mem_size);
+    out.write<uint64_t>(m_arg2patcher.size());
+    for (const auto& [key, patcher] : m_arg2patcher) {
+      out.write(key);
+      out.write(patcher.m_buf_type);
+      out.write(patcher.m_symbol_type);
+      out.write<uint64_t>(patcher.m_ctrlcode_patchinfo.size());
+      for (const auto& pi : patcher.m_ctrlcode_patchinfo) {
+        out.write(pi.offset_to_patch_buffer);
+        out.write(pi.offset_to_base_bo_addr);
+        out.write(pi.mask);
+      }
     }
+    return out.get_blob();
+  }
 
-    it->second.patch(base, patch);
-    if (xrt_core::config::get_xrt_debug()) {
-      if (not_found_use_argument_name) {
-        std::stringstream ss;
-        ss << "Patched " << patcher::section_name_to_string(type) << " using argument index " << index << " with value " << std::hex << patch;
-        xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+  // Throws if the blob is not serialized argument patchers
+  void
+  deserialize_arg_patchers(const std::vector<char>& blob)
+  {
+    xrt_core::metadata_cache::reader in(blob);
+    if (in.read<uint32_t>() != arg_patchers_version)
+      throw std::runtime_error("argument patchers version mismatch");
+
+    auto scratch_pad_mem_size = static_cast<size_t>(in.read<uint64_t>());
+    std::map<std::string, patcher> arg2patcher;
+    auto num_patchers = in.read<uint64_t>();
+    for (uint64_t idx = 0; idx < num_patchers; ++idx) {
+      auto key = in.read_string();
+      auto buf_type = in.read<patcher::buf_type>();
+      auto symbol_type = in.read<patcher::symbol_type>();
+      std::vector<patcher::patch_info> patchinfo(in.read<uint64_t>());
+      for (auto& pi : patchinfo) {
+        pi.offset_to_patch_buffer = in.read<uint64_t>();
+        pi.offset_to_base_bo_addr = in.read<uint32_t>();
+        pi.mask = in.read<uint32_t>();
       }
-      else {
-        std::stringstream ss;
-        ss << "Patched " << patcher::section_name_to_string(type) << " using argument name " << argnm << " with value " << std::hex << patch;
-        xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+      arg2patcher.emplace(std::move(key), patcher{ symbol_type, std::move(patchinfo), buf_type });
+    }
+
+    if (!in.at_end())
+      throw std::runtime_error("argument patchers have trailing data");
+
+    m_scratch_pad_mem_size = scratch_pad_mem_size;
+    m_arg2patcher = std::move(arg2patcher);
+  }
+
+  // Create the argument patchers, with the metadata cache enabled they
+  // are loaded from the cache if present and stored after creation if
+  // not.
+  template <typename CreateFunction>
+  void
+  init_arg_patchers(const ELFIO::elfio& elf, CreateFunction&& create)
+  {
+    if (!xrt_core::metadata_cache::enabled()) {
+      m_arg2patcher = create();
+      return;
+    }
+
+    auto key = xrt_core::metadata_cache::make_key
+      ("elf", m_elf.get_cfg_uuid().to_string(), hash_sections(elf));
+
+    std::vector<char> blob;
+    if (xrt_core::metadata_cache::load(key, blob)) {
+      try {
+        deserialize_arg_patchers(blob);
+        return;
+      }
+      catch (const std::exception& ex) {
+        xrt_core::message::send(xrt_core::message::severity_level::debug, "xrt_module",
+                                "Ignoring metadata cache entry " + key + ": " + ex.what());
       }
     }
+
+    m_arg2patcher = create();
+    xrt_core::metadata_cache::store(key, serialize_arg_patchers());
+  }
+
+  [[nodiscard]] const patcher*
+  get_patcher(const std::string& argnm, size_t index, patcher::buf_type type, bool& by_index) const override
+  {
+    by_index = false;
+    auto it = m_arg2patcher.find(generate_key_string(argnm, type));
+    if (it == m_arg2patcher.end()) { // Search using index
+      by_index = true;
+      it = m_arg2patcher.find(generate_key_string(std::to_string(index), type));
+      if (it == m_arg2patcher.end())
+        return nullptr;
+    }
+    return &it->second;
+  }
+
+  [[nodiscard]] bool
+  has_arg_patchers(patcher::buf_type type) const override
+  {
+    auto ctrlpkt_key = generate_key_string(Control_Packet_Symbol, patcher::buf_type::ctrltext);
+    return std::any_of(m_arg2patcher.begin(), m_arg2patcher.end(), [type, &ctrlpkt_key](const auto& entry) {
+      return entry.second.m_buf_type == type && entry.first != ctrlpkt_key;
+    });
+  }
+
+  bool
+  patch(uint8_t* base, const std::string& argnm, size_t index, uint64_t patch, patcher::buf_type type) override
+  {
+    bool by_index = false;
+    auto patcher = get_patcher(argnm, index, type, by_index);
+    if (!patcher)
+      return false;
+
+    patcher->patch(base, patch);
+    if (xrt_core::config::get_xrt_debug())
+      log_patch(type, argnm, index, by_index, patch);
     return true;
   }
 
@@ -841,8 +1130,9 @@ public:
     , m_os_abi{ xrt_core::elf_int::get_elfio(m_elf).get_os_abi() }
   {
     if (m_os_abi == Elf_Amd_Aie2ps) {
-      m_ctrlcodes = initialize_column_ctrlcode(xrt_core::elf_int::get_elfio(m_elf));
-      m_arg2patcher = initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf), m_ctrlcodes);
+      const auto& elfio = xrt_core::elf_int::get_elfio(m_elf);
+      m_ctrlcodes = initialize_column_ctrlcode(elfio);
+      init_arg_patchers(elfio, [this, &elfio] { return initialize_arg_patchers(elfio, m_ctrlcodes); });
     }
     else if (m_os_abi == Elf_Amd_Aie2p) {
       m_instr_buf = initialize_instr_buf(xrt_core::elf_int::get_elfio(m_elf));
@@ -853,7 +1143,8 @@ public:
       if (m_save_buf_exist != m_restore_buf_exist)
         throw std::runtime_error{ "Invalid elf because preempt save and restore is not paired" };
 
-      m_arg2patcher = initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf));
+      const auto& elfio = xrt_core::elf_int::get_elfio(m_elf);
+      init_arg_patchers(elfio, [this, &elfio] { return initialize_arg_patchers(elfio); });
     }
   }
 
@@ -951,10 +1242,20 @@ public:
 // Allocate a buffer object to hold the ctrlcodes for each column created
 // by parent module.  The ctrlcodes are concatenated into a single buffer
 // where buffer object address of offset for each column.
+//
+// Control code that no argument is patched into is held in buffer
+// objects shared by all module_sram instances created from the same
+// parent for the same hardware context, see share_ctrlpkt() and
+// share_instr().  Control code with arguments is copied into buffer
+// objects private to the module_sram when it is created.  It is not
+// copied on first patch instead, since the buffer addresses are
+// encoded in the command packet of the run when the run is created,
+// and since a run patches its arguments before it is started.
 class module_sram : public module_impl
 {
   std::shared_ptr<module_impl> m_parent;
   xrt::hw_context m_hwctx;
+  std::shared_ptr<shared_ctrlcode> m_shared;
 
   // The instruction buffer object contains the ctrlcodes for each
   // column.  The ctrlcodes are concatenated into a single buffer
@@ -973,9 +1274,32 @@ class module_sram : public module_impl
   // each column.
   std::vector<std::pair<uint64_t, uint64_t>> m_column_bo_address;
 
-  // Arguments patched in the ctrlcode buffer object
+  // Patchers of an argument, resolved in the parent module the first
+  // time the argument is patched and indexed by argument index after
+  // that.  The patcher pointers refer to the parent module and are
+  // nullptr if the argument is not patched in that buffer.
+  struct arg_patchers
+  {
+    std::string name;
+    bool resolved = false;
+    bool by_index = false;
+    const patcher* ctrltext = nullptr;
+    const patcher* ctrldata = nullptr;
+    std::vector<std::pair<size_t, size_t>> ctrltext_pages;
+    std::vector<std::pair<size_t, size_t>> ctrldata_pages;
+  };
+  std::vector<arg_patchers> m_arg_patchers;
+
+  // Arguments (by index) patched in the ctrlcode buffer object
   // Must match number of argument patchers in parent module
-  std::set<std::string> m_patched_args;
+  std::vector<bool> m_patched_args;
+  size_t m_num_patched_args = 0;
+
+  // Pages of each buffer (by patcher::buf_type) modified since last
+  // sync as (offset, size) ranges.  Only these are synced to device.
+  static constexpr size_t dirty_page_size = 4096;
+  std::array<std::vector<std::pair<size_t, size_t>>,
+             static_cast<size_t>(patcher::buf_type::buf_type_count)> m_dirty_ranges;
 
   // Dirty bit to indicate that patching was done prior to last
   // buffer sync to device.
@@ -1033,7 +1357,7 @@ class module_sram : public module_impl
 
   // Fill the instruction buffer object with the ctrlcodes for each
   // column and sync the buffer to device.
-  void
+  static void
   fill_instruction_buffer(xrt::bo& bo, const std::vector<ctrlcode>& ctrlcodes)
   {
     auto ptr = bo.map<char*>();
@@ -1044,7 +1368,7 @@ class module_sram : public module_impl
     bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
   }
 
-  void
+  static void
   fill_bo_with_data(xrt::bo& bo, const buf& buf)
   {
     auto ptr = bo.map<char*>();
@@ -1052,28 +1376,91 @@ class module_sram : public module_impl
     bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
   }
 
-  void
-  fill_ctrlpkt_buf(xrt::bo& bo, const control_packet& ctrlpktbuf)
+  // The control packet is shared if no argument is patched into it
+  static bool
+  share_ctrlpkt(const module_impl* parent)
   {
-    auto ptr = bo.map<char*>();
-    std::memcpy(ptr, ctrlpktbuf.data(), ctrlpktbuf.size());
-    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    return !parent->has_arg_patchers(patcher::buf_type::ctrldata);
+  }
+
+  // The instruction buffer is shared if no argument is patched into
+  // it.  The Aie2p instruction buffer is patched with the address of
+  // the control packet, so the control packet must be shared too.
+  static bool
+  share_instr(const module_impl* parent)
+  {
+    return !parent->has_arg_patchers(patcher::buf_type::ctrltext) && share_ctrlpkt(parent);
+  }
+
+  // Create the shared buffer objects.  The control packet is created
+  // first because its address is patched into the instruction buffer.
+  static std::shared_ptr<shared_ctrlcode>
+  create_shared_ctrlcode(const module_impl* parent, const xrt::hw_context& hwctx)
+  {
+    auto shared = std::make_shared<shared_ctrlcode>();
+    auto os_abi = parent->get_os_abi();
+
+    if (os_abi == Elf_Amd_Aie2p) {
+      const auto& ctrlpkt = parent->get_ctrlpkt();
+      if (share_ctrlpkt(parent) && ctrlpkt.size() > 0) {
+        shared->ctrlpkt = xrt::ext::bo{ hwctx, ctrlpkt.size() };
+        fill_bo_with_data(shared->ctrlpkt, ctrlpkt);
+      }
+
+      const auto& data = parent->get_instr();
+      if (!share_instr(parent) || data.size() == 0)
+        return shared;
+
+      shared->instr = xrt::bo{ hwctx, data.size(), xrt::bo::flags::cacheable, 1 /* fix me */ };
+      auto ptr = shared->instr.map<uint8_t*>();
+      std::memcpy(ptr, data.data(), data.size());
+
+      bool by_index = false;
+      auto patcher = parent->get_patcher(Control_Packet_Symbol, 0, patcher::buf_type::ctrltext, by_index);
+      if (shared->ctrlpkt && patcher) {
+        patcher->patch(ptr, shared->ctrlpkt.address());
+        if (xrt_core::config::get_xrt_debug())
+          log_patch(patcher::buf_type::ctrltext, Control_Packet_Symbol, 0, by_index, shared->ctrlpkt.address());
+      }
+      shared->instr.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+    else if (os_abi == Elf_Amd_Aie2ps) {
+      if (!share_instr(parent))
+        return shared;
+
+      const auto& data = parent->get_data();
+      size_t sz = std::accumulate(data.begin(), data.end(), static_cast<size_t>(0), [](auto acc, const auto& ctrlcode) {
+        return acc + ctrlcode.size();
+        });
+      if (sz == 0)
+        return shared;
+
+      shared->instr = xrt::bo{ hwctx, sz, xrt::bo::flags::cacheable, 1 /* fix me */ };
+      fill_instruction_buffer(shared->instr, data);
+    }
+
+    return shared;
   }
 
   void
   create_instr_buf(const module_impl* parent)
   {
     XRT_DEBUGF("-> module_sram::create_instr_buf()\n");
-    const auto& data = parent->get_instr();
-    size_t sz = data.size();
-    if (sz == 0)
-      throw std::runtime_error("Invalid instruction buffer size");
+    if (m_shared->instr) {
+      m_instr_bo = m_shared->instr;
+    }
+    else {
+      const auto& data = parent->get_instr();
+      if (data.size() == 0)
+        throw std::runtime_error("Invalid instruction buffer size");
 
-    // create bo combined size of all ctrlcodes
-    m_instr_bo = xrt::bo{ m_hwctx, sz, xrt::bo::flags::cacheable, 1 /* fix me */ };
+      // create bo combined size of all ctrlcodes
+      m_instr_bo = xrt::bo{ m_hwctx, data.size(), xrt::bo::flags::cacheable, 1 /* fix me */ };
 
-    // copy instruction into bo
-    fill_bo_with_data(m_instr_bo, data);
+      // copy instruction into bo
+      fill_bo_with_data(m_instr_bo, data);
+    }
+    auto sz = m_instr_bo.size();
 
     if (is_dump_control_codes()) {
       std::string dump_file_name = "ctr_codes_pre_patch" + std::to_string(get_id()) + ".bin";
@@ -1126,7 +1513,8 @@ class module_sram : public module_impl
       }
     }
 
-    if (m_ctrlpkt_bo) {
+    // shared instruction buffer is patched when created
+    if (m_ctrlpkt_bo && !m_shared->instr) {
       patch_instr(m_instr_bo, Control_Packet_Symbol, 0, m_ctrlpkt_bo, patcher::buf_type::ctrltext);
     }
     XRT_DEBUGF("<- module_sram::create_instr_buf()\n");
@@ -1143,9 +1531,13 @@ class module_sram : public module_impl
       return;
     }
 
-    m_ctrlpkt_bo = xrt::ext::bo{ m_hwctx, sz };
-
-    fill_ctrlpkt_buf(m_ctrlpkt_bo, data);
+    if (m_shared->ctrlpkt) {
+      m_ctrlpkt_bo = m_shared->ctrlpkt;
+    }
+    else {
+      m_ctrlpkt_bo = xrt::ext::bo{ m_hwctx, sz };
+      fill_bo_with_data(m_ctrlpkt_bo, data);
+    }
 
     if (is_dump_control_packet()) {
         std::string dump_file_name = "ctr_packet_pre_patch" + std::to_string(get_id()) + ".bin";
@@ -1158,10 +1550,15 @@ class module_sram : public module_impl
   }
 
   // Create the instruction buffer object and fill it with column
-  // ctrlcodes.
+  // ctrlcodes, unless the shared one is used.
   void
   create_instruction_buffer(const module_impl* parent)
   {
+    if (m_shared->instr) {
+      m_buffer = m_shared->instr;
+      return;
+    }
+
     const auto& data = parent->get_data();
 
     // create bo combined size of all ctrlcodes
@@ -1184,37 +1581,159 @@ class module_sram : public module_impl
     patch_instr_value(bo_ctrlcode, argnm, index, bo.address(), type);
   }
 
+  // Buffer object patched for a buffer type
+  xrt::bo&
+  get_patch_bo(patcher::buf_type type)
+  {
+    switch (type) {
+    case patcher::buf_type::ctrltext:
+      return (m_parent->get_os_abi() == Elf_Amd_Aie2p) ? m_instr_bo : m_buffer;
+    case patcher::buf_type::ctrldata:
+      return m_ctrlpkt_bo;
+    case patcher::buf_type::preempt_save:
+      return m_preempt_save_bo;
+    case patcher::buf_type::preempt_restore:
+      return m_preempt_restore_bo;
+    default:
+      throw std::runtime_error("Invalid patch buffer type");
+    }
+  }
+
+  // Unpatched control code at an offset of the buffer patched for a
+  // buffer type.  The Aie2ps column ctrlcodes are concatenated in the
+  // buffer object.
+  const uint8_t*
+  get_original(patcher::buf_type type, size_t offset) const
+  {
+    switch (type) {
+    case patcher::buf_type::ctrltext:
+      if (m_parent->get_os_abi() == Elf_Amd_Aie2p)
+        return m_parent->get_instr().data() + offset;
+      for (const auto& ctrlcode : m_parent->get_data()) {
+        if (offset < ctrlcode.size())
+          return ctrlcode.data() + offset;
+        offset -= ctrlcode.size();
+      }
+      throw std::runtime_error("Invalid patch offset");
+    case patcher::buf_type::ctrldata:
+      return m_parent->get_ctrlpkt().data() + offset;
+    case patcher::buf_type::preempt_save:
+      return m_parent->get_preempt_save().data() + offset;
+    case patcher::buf_type::preempt_restore:
+      return m_parent->get_preempt_restore().data() + offset;
+    default:
+      throw std::runtime_error("Invalid patch buffer type");
+    }
+  }
+
+  void
+  apply_patch(const patcher* patcher, const std::vector<std::pair<size_t, size_t>>& pages,
+              patcher::buf_type type, uint64_t value)
+  {
+    auto base = get_patch_bo(type).map<uint8_t*>();
+    patcher->restore(base, [this, type](size_t offset) { return get_original(type, offset); });
+    patcher->patch(base, value);
+    auto& dirty = m_dirty_ranges[static_cast<size_t>(type)];
+    dirty.insert(dirty.end(), pages.begin(), pages.end());
+    m_dirty = true;
+
+    // bound the list when arguments are patched repeatedly between syncs
+    constexpr size_t max_dirty_ranges = 1024;
+    if (dirty.size() > max_dirty_ranges) {
+      std::sort(dirty.begin(), dirty.end());
+      dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    }
+  }
+
+  // Get the patchers of an argument, resolving them in the parent
+  // module first time the argument is patched.
+  const arg_patchers&
+  get_arg_patchers(const std::string& argnm, size_t index)
+  {
+    if (index >= m_arg_patchers.size())
+      m_arg_patchers.resize(index + 1);
+
+    auto& entry = m_arg_patchers[index];
+    if (entry.resolved && entry.name == argnm)
+      return entry;
+
+    entry = arg_patchers{};
+    entry.name = argnm;
+    entry.resolved = true;
+    bool by_index = false;
+    entry.ctrltext = m_parent->get_patcher(argnm, index, patcher::buf_type::ctrltext, entry.by_index);
+    if (entry.ctrltext)
+      entry.ctrltext_pages = entry.ctrltext->patch_pages(dirty_page_size);
+
+    // control-packet buffer is patched only for Aie2p
+    if (m_ctrlpkt_bo && m_parent->get_os_abi() == Elf_Amd_Aie2p)
+      entry.ctrldata = m_parent->get_patcher(argnm, index, patcher::buf_type::ctrldata, by_index);
+    if (entry.ctrldata)
+      entry.ctrldata_pages = entry.ctrldata->patch_pages(dirty_page_size);
+    if (!entry.ctrltext)
+      entry.by_index = by_index;
+
+    return entry;
+  }
+
   void
   patch_value(const std::string& argnm, size_t index, uint64_t value)
   {
-    bool patched = false;
-    if (m_parent->get_os_abi() == Elf_Amd_Aie2p) {
-      // patch control-packet buffer
-      if (m_ctrlpkt_bo) {
-        if (m_parent->patch(m_ctrlpkt_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrldata))
-          patched = true;
-      }
+    const auto& entry = get_arg_patchers(argnm, index);
+    if (!entry.ctrltext && !entry.ctrldata)
+      return;
 
-      // patch instruction buffer
-      if (m_parent->patch(m_instr_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
-          patched = true;
+    if (entry.ctrldata)
+      apply_patch(entry.ctrldata, entry.ctrldata_pages, patcher::buf_type::ctrldata, value);
+    if (entry.ctrltext)
+      apply_patch(entry.ctrltext, entry.ctrltext_pages, patcher::buf_type::ctrltext, value);
+
+    if (xrt_core::config::get_xrt_debug()) {
+      if (entry.ctrldata)
+        log_patch(patcher::buf_type::ctrldata, argnm, index, entry.by_index, value);
+      if (entry.ctrltext)
+        log_patch(patcher::buf_type::ctrltext, argnm, index, entry.by_index, value);
     }
-    else if (m_parent->patch(m_buffer.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
-      patched = true;
 
-    if (patched) {
-      m_patched_args.insert(argnm);
-      m_dirty = true;
+    if (index >= m_patched_args.size())
+      m_patched_args.resize(index + 1);
+    if (!m_patched_args[index]) {
+      m_patched_args[index] = true;
+      ++m_num_patched_args;
     }
   }
 
   void
   patch_instr_value(xrt::bo& bo, const std::string& argnm, size_t index, uint64_t value, patcher::buf_type type)
   {
-    if (!m_parent->patch(bo.map<uint8_t*>(), argnm, index, value, type))
+    bool by_index = false;
+    auto patcher = m_parent->get_patcher(argnm, index, type, by_index);
+    if (!patcher)
       return;
 
-    m_dirty = true;
+    if (&bo != &get_patch_bo(type))
+      throw std::runtime_error("Invalid buffer object for patch buffer type");
+
+    apply_patch(patcher, patcher->patch_pages(dirty_page_size), type, value);
+    if (xrt_core::config::get_xrt_debug())
+      log_patch(type, argnm, index, by_index, value);
+  }
+
+  // Sync the modified pages of a patched buffer object to device
+  void
+  sync_dirty_range(patcher::buf_type type)
+  {
+    auto& dirty = m_dirty_ranges[static_cast<size_t>(type)];
+    if (dirty.empty())
+      return;
+
+    // last page may extend past the end of the buffer
+    auto& bo = get_patch_bo(type);
+    for (auto& [offset, size] : dirty)
+      size = std::min(size, bo.size() - offset);
+
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, dirty);
+    dirty.clear();
   }
 
   void
@@ -1243,15 +1762,15 @@ class module_sram : public module_impl
 
     auto os_abi = m_parent.get()->get_os_abi();
     if (os_abi == Elf_Amd_Aie2ps) {
-      if (m_patched_args.size() != m_parent->number_of_arg_patchers()) {
+      if (m_num_patched_args != m_parent->number_of_arg_patchers()) {
         auto fmt = boost::format("ctrlcode requires %d patched arguments, but only %d are patched")
-            % m_parent->number_of_arg_patchers() % m_patched_args.size();
+            % m_parent->number_of_arg_patchers() % m_num_patched_args;
         throw std::runtime_error{ fmt.str() };
       }
-      m_buffer.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      sync_dirty_range(patcher::buf_type::ctrltext);
     }
     else if (os_abi == Elf_Amd_Aie2p) {
-      m_instr_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      sync_dirty_range(patcher::buf_type::ctrltext);
 
       if (is_dump_control_codes()) {
         std::string dump_file_name = "ctr_codes_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1263,7 +1782,7 @@ class module_sram : public module_impl
       }
 
       if (m_ctrlpkt_bo) {
-        m_ctrlpkt_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        sync_dirty_range(patcher::buf_type::ctrldata);
 
         if (is_dump_control_packet()) {
           std::string dump_file_name = "ctr_packet_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1276,8 +1795,8 @@ class module_sram : public module_impl
       }
 
       if (m_preempt_save_bo && m_preempt_restore_bo) {
-        m_preempt_save_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        m_preempt_restore_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        sync_dirty_range(patcher::buf_type::preempt_save);
+        sync_dirty_range(patcher::buf_type::preempt_restore);
 
         if (is_dump_preemption_codes()) {
           std::string dump_file_name = "preemption_save_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1363,6 +1882,10 @@ public:
 
     auto os_abi = m_parent.get()->get_os_abi();
 
+    m_shared = m_parent->get_shared_ctrlcode(m_hwctx, [this] {
+      return create_shared_ctrlcode(m_parent.get(), m_hwctx);
+    });
+
     if (os_abi == Elf_Amd_Aie2p) {
       // make sure to create control-packet buffer frist because we may
       // need to patch control-packet address to instruction buffer
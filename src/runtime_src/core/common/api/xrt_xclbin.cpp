@@ -8,9 +8,11 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/include/experimental/xrt_xclbin.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
 #include "core/common/message.h"
+#include "core/common/metadata_cache.h"
 #include "core/common/module_loader.h"
 #include "core/common/query_requests.h"
 #include "core/common/xclbin_parser.h"
@@ -38,6 +40,10 @@
 # pragma warning( disable : 4244 4267 4996)
 #else
 # include <linux/uuid.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
 #endif
 
 namespace {
@@ -100,6 +106,240 @@ copy_axlf(const axlf* top)
   return header;
 }
 
+// struct xml_model - kernel meta data from the XML meta data section
+//
+// This is the part of the xclbin meta data that must be parsed, all
+// other sections are used in place.  The model is stored in the
+// metadata cache when the cache is enabled.
+struct xml_model
+{
+  struct kernel
+  {
+    std::string name;
+    xrt_core::xclbin::kernel_properties properties;
+    std::vector<xrt_core::xclbin::kernel_argument> args;
+  };
+
+  std::string project_name;
+  std::string fpga_device_name;
+  std::vector<kernel> kernels;
+};
+
+// Increment when the serialized xml_model changes
+constexpr uint32_t xml_model_version = 1;
+
+static xml_model
+parse_xml_model(const xrt_core::xclbin::xml_metadata& xml)
+{
+  xml_model model;
+  model.project_name = xrt_core::xclbin::get_project_name(xml);
+  model.fpga_device_name = xrt_core::xclbin::get_fpga_device_name(xml);
+  for (auto& kernel : xrt_core::xclbin::get_kernels(xml)) {
+    auto props = xrt_core::xclbin::get_kernel_properties(xml, kernel.name);
+    model.kernels.push_back({std::move(kernel.name), std::move(props), std::move(kernel.args)});
+  }
+  return model;
+}
+
+static std::vector<char>
+serialize_xml_model(const xml_model& model)
+{
+  xrt_core::metadata_cache::writer out;
+  out.write(xml_model_version);
+  out.write(model.project_name);
+  out.write(model.fpga_device_name);
+
+  out.write<uint64_t>(model.kernels.size());
+  for (const auto& kernel : model.kernels) {
+    out.write(kernel.name);
+
+    const auto& props = kernel.properties;
+    out.write(props.name);
+    out.write(props.type);
+    out.write(props.counted_auto_restart);
+    out.write(props.mailbox);
+    out.write(props.address_range);
+    out.write(props.sw_reset);
+    out.write(props.functional);
+    out.write(props.kernel_id);
+    out.write(props.workgroupsize);
+    for (auto size : props.compileworkgroupsize)
+      out.write(size);
+    for (auto size : props.maxworkgroupsize)
+      out.write(size);
+    out.write<uint64_t>(props.stringtable.size());
+    for (const auto& [id, str] : props.stringtable) {
+      out.write(id);
+      out.write(str);
+    }
+
+    out.write<uint64_t>(kernel.args.size());
+    for (const auto& arg : kernel.args) {
+      out.write(arg.name);
+      out.write(arg.hosttype);
+      out.write(arg.port);
+      out.write(arg.port_width);
+      out.write(arg.index);
+      out.write(arg.offset);
+      out.write(arg.size);
+      out.write(arg.hostsize);
+      out.write(arg.fa_desc_offset);
+      out.write(arg.type);
+      out.write(arg.dir);
+    }
+  }
+
+  return out.get_blob();
+}
+
+// Throws if the blob is not a serialized xml_model
+static xml_model
+deserialize_xml_model(const std::vector<char>& blob)
+{
+  using kernel_argument = xrt_core::xclbin::kernel_argument;
+  using kernel_properties = xrt_core::xclbin::kernel_properties;
+
+  xrt_core::metadata_cache::reader in(blob);
+  if (in.read<uint32_t>() != xml_model_version)
+    throw std::runtime_error("xml model version mismatch");
+
+  xml_model model;
+  model.project_name = in.read_string();
+  model.fpga_device_name = in.read_string();
+
+  auto num_kernels = in.read<uint64_t>();
+  for (uint64_t kidx = 0; kidx < num_kernels; ++kidx) {
+    auto& kernel = model.kernels.emplace_back();
+    kernel.name = in.read_string();
+
+    auto& props = kernel.properties;
+    props.name = in.read_string();
+    props.type = in.read<kernel_properties::kernel_type>();
+    props.counted_auto_restart = in.read<kernel_properties::restart_type>();
+    props.mailbox = in.read<kernel_properties::mailbox_type>();
+    props.address_range = in.read<size_t>();
+    props.sw_reset = in.read<bool>();
+    props.functional = in.read<size_t>();
+    props.kernel_id = in.read<size_t>();
+    props.workgroupsize = in.read<size_t>();
+    for (auto& size : props.compileworkgroupsize)
+      size = in.read<size_t>();
+    for (auto& size : props.maxworkgroupsize)
+      size = in.read<size_t>();
+    auto num_strings = in.read<uint64_t>();
+    for (uint64_t sidx = 0; sidx < num_strings; ++sidx) {
+      auto id = in.read<uint32_t>();
+      props.stringtable.emplace(id, in.read_string());
+    }
+
+    auto num_args = in.read<uint64_t>();
+    for (uint64_t aidx = 0; aidx < num_args; ++aidx) {
+      auto& arg = kernel.args.emplace_back();
+      arg.name = in.read_string();
+      arg.hosttype = in.read_string();
+      arg.port = in.read_string();
+      arg.port_width = in.read<size_t>();
+      arg.index = in.read<size_t>();
+      arg.offset = in.read<size_t>();
+      arg.size = in.read<size_t>();
+      arg.hostsize = in.read<size_t>();
+      arg.fa_desc_offset = in.read<size_t>();
+      arg.type = in.read<kernel_argument::argtype>();
+      arg.dir = in.read<kernel_argument::direction>();
+    }
+  }
+
+  if (!in.at_end())
+    throw std::runtime_error("xml model has trailing data");
+
+  return model;
+}
+
+// class axlf_buffer - raw data of an xclbin
+//
+// The data is either owned by the buffer or is a read-only private
+// mapping of an xclbin file.  A mapped file is paged in on demand and
+// shares pages with the page cache, so sections that are never
+// accessed (bitstreams, PDIs not loaded by this process) are never
+// read into memory.
+class axlf_buffer
+{
+  std::vector<char> m_data;
+  void* m_map = nullptr;
+  size_t m_size = 0;
+
+#ifndef _WIN32
+  // Map the file, returns false if the file cannot be mapped
+  bool
+  map(const std::string& fnm)
+  {
+    auto fd = open(fnm.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+
+    struct stat sb {};
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0)
+      addr = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file open
+
+    if (addr == MAP_FAILED)
+      return false;
+
+    m_map = addr;
+    m_size = sb.st_size;
+    return true;
+  }
+#endif
+
+public:
+  explicit
+  axlf_buffer(std::vector<char> data)
+    : m_data(std::move(data))
+    , m_size(m_data.size())
+  {}
+
+  // Map the xclbin file, falls back on reading the file if mapping
+  // is disabled or not possible
+  explicit
+  axlf_buffer(const std::string& fnm)
+  {
+    if (fnm.empty())
+      throw std::runtime_error("No xclbin specified");
+
+    auto path = xrt_core::environment::platform_path(fnm).string();
+#ifndef _WIN32
+    if (xrt_core::config::get_xclbin_mmap() && map(path))
+      return;
+#endif
+    m_data = read_file(path);
+    m_size = m_data.size();
+  }
+
+  ~axlf_buffer()
+  {
+#ifndef _WIN32
+    if (m_map)
+      munmap(m_map, m_size);
+#endif
+  }
+
+  axlf_buffer(const axlf_buffer&) = delete;
+  axlf_buffer& operator=(const axlf_buffer&) = delete;
+
+  const char*
+  data() const
+  {
+    return m_map ? static_cast<const char*>(m_map) : m_data.data();
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+};
+
 // Default implementation to get the name of an element
 template <typename ElementType>
 static std::string
@@ -448,21 +688,16 @@ class xclbin_impl
     // Pre-condition for this function is that init_mems() and init_ips()
     // have been called.
     static std::vector<xclbin::kernel>
-    init_kernels(const xclbin_impl* ximpl, const std::vector<xclbin::ip>& ips)
+    init_kernels(std::vector<xml_model::kernel>&& xml_kernels, const std::vector<xclbin::ip>& ips)
     {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      if (!xml.first)
-        return {};
-
       // get kernel CUs from xclbin meta data
       std::vector<xclbin::kernel> kernels;
-      for (auto& kernel : xrt_core::xclbin::get_kernels(xml.first, xml.second)) {
-        auto props = xrt_core::xclbin::get_kernel_properties(xml.first, xml.second, kernel.name);
+      for (auto& kernel : xml_kernels) {
         std::vector<xclbin::ip> cus;
         copy_if_name_match(ips.begin(), ips.end(), std::back_inserter(cus), kernel.name);
         kernels.emplace_back
           (std::make_shared<xclbin::kernel_impl>
-           (std::move(kernel.name), std::move(props), std::move(cus), std::move(kernel.args)));
+           (std::move(kernel.name), std::move(kernel.properties), std::move(cus), std::move(kernel.args)));
       }
 
       return kernels;
@@ -480,22 +715,48 @@ class xclbin_impl
       return aie_partitions;
     }
 
-    static std::string
-    init_project_name(const xclbin_impl* ximpl)
+    // init_xml_model() - extract the XML meta data once for all the
+    // init functions that need it
+    //
+    // With the metadata cache enabled, the model is loaded from the
+    // cache if present and stored in the cache after parsing if not.
+    // The kernel properties include the xrt.ini mailbox, auto restart
+    // and sw reset kernel settings, which are part of the key so that
+    // changing xrt.ini does not load stale properties.
+    static xml_model
+    init_xml_model(const xclbin_impl* ximpl)
     {
       auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      return xml.first
-        ? xrt_core::xclbin::get_project_name(xml.first, xml.second)
-        : "";
-    }
+      if (!xml.first)
+        return {};
 
-    static std::string
-    init_fpga_device_name(const xclbin_impl* ximpl)
-    {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      return xml.first
-        ? xrt_core::xclbin::get_fpga_device_name(xml.first, xml.second)
-        : "";
+      if (!xrt_core::metadata_cache::enabled())
+        return parse_xml_model(*xrt_core::xclbin::get_xml_metadata(xml.first, xml.second));
+
+      auto hash = xrt_core::metadata_cache::hash(xml.first, xml.second);
+      for (const auto& setting : { xrt_core::config::get_mailbox_kernels()
+                                 , xrt_core::config::get_auto_restart_kernels()
+                                 , xrt_core::config::get_sw_reset_kernels() }) {
+        uint64_t size = setting.size();
+        hash = xrt_core::metadata_cache::hash(&size, sizeof(size), hash);
+        hash = xrt_core::metadata_cache::hash(setting.data(), setting.size(), hash);
+      }
+      auto key = xrt_core::metadata_cache::make_key("xclbin", ximpl->get_uuid().to_string(), hash);
+
+      std::vector<char> blob;
+      if (xrt_core::metadata_cache::load(key, blob)) {
+        try {
+          return deserialize_xml_model(blob);
+        }
+        catch (const std::exception& ex) {
+          xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT",
+                                  "Ignoring metadata cache entry " + key + ": " + ex.what());
+        }
+      }
+
+      auto model = parse_xml_model(*xrt_core::xclbin::get_xml_metadata(xml.first, xml.second));
+      xrt_core::metadata_cache::store(key, serialize_xml_model(model));
+      return model;
     }
 
     // init_mem_encoding() - compress memory indices
@@ -568,18 +829,22 @@ class xclbin_impl
       return enc;
     }
 
-    // xclbin_info() - constructor for xclbin meta data
-    explicit
-    xclbin_info(const xrt::xclbin_impl* impl)
+    xclbin_info(const xrt::xclbin_impl* impl, xml_model&& xml)
       : m_ximpl(impl)
-      , m_project_name(init_project_name(m_ximpl))
-      , m_fpga_device_name(init_fpga_device_name(m_ximpl))
+      , m_project_name(std::move(xml.project_name))
+      , m_fpga_device_name(std::move(xml.fpga_device_name))
       , m_mems(init_mems(m_ximpl))
       , m_ips(init_ips(m_ximpl, m_mems))
-      , m_kernels(init_kernels(m_ximpl, m_ips))
+      , m_kernels(init_kernels(std::move(xml.kernels), m_ips))
       , m_aie_partitions(init_aie_partitions(m_ximpl))
       , m_membank_encoding(init_mem_encoding(m_mems))
     {}
+
+    // xclbin_info() - constructor for xclbin meta data
+    explicit
+    xclbin_info(const xrt::xclbin_impl* impl)
+      : xclbin_info(impl, init_xml_model(impl))
+    {}
   };
 
   // cache of meta data extracted from xclbin
@@ -755,20 +1020,33 @@ public:
 // binary images for file content
 class xclbin_full : public xclbin_impl
 {
-  std::vector<char> m_axlf;    // complete copy of xclbin raw data
+  axlf_buffer m_axlf;          // xclbin raw data, mapped or owned
   const axlf* m_top = nullptr; // axlf pointer to the raw data
   uuid m_uuid;                 // uuid of xclbin
   uuid m_intf_uuid;
 
-  // sections within this xclbin
-  std::multimap<axlf_section_kind, std::vector<char>> m_axlf_sections;
+  // sections within this xclbin, these refer to the raw data
+  std::multimap<axlf_section_kind, std::pair<const char*, size_t>> m_axlf_sections;
+
+  // copies of sections that are not suitably aligned in the raw data
+  std::vector<std::vector<char>> m_section_copies;
 
   void
   emplace_section(const axlf_section_header* hdr, axlf_section_kind kind)
   {
+    if (hdr->m_sectionOffset > m_axlf.size() || hdr->m_sectionSize > m_axlf.size() - hdr->m_sectionOffset)
+      throw std::runtime_error("Invalid xclbin, section exceeds xclbin size");
+
     auto section_data = reinterpret_cast<const char*>(m_top) + hdr->m_sectionOffset;
-    std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
-    m_axlf_sections.emplace(kind , std::move(data));
+    auto section_size = static_cast<size_t>(hdr->m_sectionSize);
+
+    // Sections are accessed as structures with 64-bit members
+    if (reinterpret_cast<uintptr_t>(section_data) % alignof(uint64_t)) {
+      m_section_copies.emplace_back(section_data, section_data + section_size);
+      section_data = m_section_copies.back().data();
+    }
+
+    m_axlf_sections.emplace(kind, std::make_pair(section_data, section_size));
   }
 
   void
@@ -784,8 +1062,23 @@ class xclbin_full : public xclbin_impl
   init_axlf()
   {
     const axlf* tmp = reinterpret_cast<const axlf*>(m_axlf.data());
-    if (strncmp(tmp->m_magic, "xclbin2", strlen("xclbin2")) != 0) // Future: Do not hardcode "xclbin2"
+    if (m_axlf.size() < offsetof(axlf, m_sections)
+        || strncmp(tmp->m_magic, "xclbin2", strlen("xclbin2")) != 0) // Future: Do not hardcode "xclbin2"
       throw std::runtime_error("Invalid xclbin");
+
+    // Section headers and sections must be within the xclbin, the
+    // data can come straight from a file
+    uint64_t size = m_axlf.size();
+    uint64_t hdr_size = offsetof(axlf, m_sections)
+      + uint64_t(tmp->m_header.m_numSections) * sizeof(axlf_section_header);
+    if (hdr_size > size)
+      throw std::runtime_error("Invalid xclbin, section headers exceed xclbin size");
+    for (uint32_t idx = 0; idx < tmp->m_header.m_numSections; ++idx) {
+      const auto& hdr = tmp->m_sections[idx];
+      if (hdr.m_sectionOffset > size || hdr.m_sectionSize > size - hdr.m_sectionOffset)
+        throw std::runtime_error("Invalid xclbin, section " + std::to_string(idx) + " exceeds xclbin size");
+    }
+
     m_top = tmp;
 
     m_uuid = uuid(m_top->m_header.uuid);
@@ -814,7 +1107,7 @@ class xclbin_full : public xclbin_impl
 public:
   explicit
   xclbin_full(const std::string& filename)
-    : m_axlf(read_xclbin(filename))
+    : m_axlf(filename)
   {
     init();
   }
@@ -875,7 +1168,7 @@ public:
   {
     auto itr = m_axlf_sections.find(kind);
     return itr != m_axlf_sections.end()
-      ? std::make_pair((*itr).second.data(), (*itr).second.size())
+      ? (*itr).second
       : std::make_pair(nullptr, size_t(0));
   }
 
@@ -890,7 +1183,7 @@ public:
       std::vector<std::pair<const char*, size_t>> return_sections;
 
       for (auto itr = result.first; itr != result.second; itr++)
-        return_sections.emplace_back(std::make_pair(itr->second.data(), itr->second.size()));
+        return_sections.emplace_back(itr->second);
 
       return return_sections;
     }
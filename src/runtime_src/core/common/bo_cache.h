@@ -10,9 +10,14 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/include/ert.h"
 
-#include <vector>
-#include <utility>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( push )
@@ -116,6 +121,258 @@ private:
 
 using bo_cache = bo_cache_t<4096>;
 
+// class bo_pool - Size classed pool of command BO objects
+//
+// Command BOs are grouped in power of two size classes starting at
+// min_size.  Released BOs are cached per size class in a fixed array
+// of slots.  A slot is claimed by compare-and-swap of its state, so
+// alloc and release never block; a slot that is busy is skipped.
+// Each thread starts its slot scan at a thread specific offset such
+// that threads allocating and releasing concurrently mostly touch
+// different slots.
+//
+// The number of cached BOs in a size class is trimmed against the
+// high water mark of BOs in use.  The high water mark is the peak
+// number of BOs in use during the previous trim interval.  BOs
+// beyond what is needed to reach the high water mark again are
+// destroyed when released.
+//
+// A pool is shared by all users of the same device, see get().
+class bo_pool
+{
+public:
+  template <typename CommandType>
+  using cmd_bo = bo_cache::cmd_bo<CommandType>;
+
+  static constexpr size_t min_size = 4096;
+  static constexpr size_t num_classes = 4;     // 4K, 8K, 16K, 32K
+  static constexpr unsigned int trim_interval = 1024; // releases
+
+private:
+  enum slot_state : int { empty, busy, full };
+
+  struct slot
+  {
+    std::atomic<int> state {empty};
+    std::unique_ptr<buffer_handle> handle;
+    void* map = nullptr;
+  };
+
+  struct size_class
+  {
+    std::unique_ptr<slot[]> slots;
+    std::atomic<unsigned int> cached {0};
+    std::atomic<unsigned int> in_use {0};
+    std::atomic<unsigned int> peak {0};
+    std::atomic<unsigned int> high_water {0};
+    std::atomic<unsigned int> releases {0};
+  };
+
+  std::shared_ptr<device> m_device;
+  // Maximum number of BOs cached per size class.  Value of 0
+  // disables caching.
+  const unsigned int m_max_size;
+  std::array<size_class, num_classes> m_classes;
+
+  // Size class of argument size, num_classes if size is too big
+  static size_t
+  get_class(size_t size)
+  {
+    size_t idx = 0;
+    for (auto sz = min_size; sz < size && idx < num_classes; sz <<= 1)
+      ++idx;
+    return idx;
+  }
+
+  // Thread specific start of slot scan
+  size_t
+  get_start() const
+  {
+    static thread_local size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return hash % m_max_size;
+  }
+
+  cmd_bo<void>
+  take(size_class& sc)
+  {
+    auto start = get_start();
+    for (size_t i = 0; i < m_max_size; ++i) {
+      auto& s = sc.slots[(start + i) % m_max_size];
+      int expected = full;
+      if (s.state.load(std::memory_order_relaxed) != full
+          || !s.state.compare_exchange_strong(expected, busy, std::memory_order_acquire))
+        continue;
+
+      --sc.cached;
+      cmd_bo<void> bo {std::move(s.handle), s.map};
+      s.state.store(empty, std::memory_order_release);
+      return bo;
+    }
+    return {nullptr, nullptr};
+  }
+
+  bool
+  put(size_class& sc, cmd_bo<void>& bo)
+  {
+    auto start = get_start();
+    for (size_t i = 0; i < m_max_size; ++i) {
+      auto& s = sc.slots[(start + i) % m_max_size];
+      int expected = empty;
+      if (s.state.load(std::memory_order_relaxed) != empty
+          || !s.state.compare_exchange_strong(expected, busy, std::memory_order_acquire))
+        continue;
+
+      // cached must be incremented before the slot is visible as
+      // full, or take() could decrement it first
+      ++sc.cached;
+      s.handle = std::move(bo.first);
+      s.map = bo.second;
+      s.state.store(full, std::memory_order_release);
+      return true;
+    }
+    return false;
+  }
+
+  static void
+  destroy(const cmd_bo<void>& bo)
+  {
+    bo.first->unmap(bo.second);
+  }
+
+  cmd_bo<void>
+  alloc_impl(size_t size)
+  {
+    auto idx = get_class(size);
+    if (idx < num_classes && m_max_size) {
+      auto& sc = m_classes[idx];
+      auto used = ++sc.in_use;
+      auto peak = sc.peak.load();
+      while (used > peak && !sc.peak.compare_exchange_weak(peak, used))
+        ;
+
+      if (sc.cached.load(std::memory_order_relaxed)) {
+        if (auto bo = take(sc); bo.first)
+          return bo;
+      }
+
+      size = min_size << idx;
+    }
+
+    auto execHandle = m_device->alloc_bo(size, XCL_BO_FLAGS_EXECBUF);
+    auto map = execHandle->map(buffer_handle::map_type::write);
+    return std::make_pair(std::move(execHandle), map);
+  }
+
+  void
+  release_impl(cmd_bo<void>&& bo, size_t size)
+  {
+    auto idx = get_class(size);
+    if (idx == num_classes || !m_max_size) {
+      destroy(bo);
+      return;
+    }
+
+    auto& sc = m_classes[idx];
+    auto used = --sc.in_use;
+
+    // Start a new trim interval, the peak of the interval that
+    // just ended is the new high water mark
+    if (++sc.releases % trim_interval == 0) {
+      sc.high_water = sc.peak.exchange(used);
+    }
+
+    auto target = std::max(sc.high_water.load(), sc.peak.load());
+    if (used + sc.cached.load(std::memory_order_relaxed) < target && put(sc, bo))
+      return;
+
+    destroy(bo);
+
+    // Trim one more cached BO if still above high water mark
+    if (used + sc.cached.load(std::memory_order_relaxed) > target) {
+      if (auto extra = take(sc); extra.first)
+        destroy(extra);
+    }
+  }
+
+public:
+  bo_pool(std::shared_ptr<xrt_core::device> device, unsigned int max_size)
+    : m_device(std::move(device)), m_max_size(max_size)
+  {
+    for (auto& sc : m_classes)
+      sc.slots = std::make_unique<slot[]>(m_max_size);
+  }
+
+  bo_pool(xclDeviceHandle handle, unsigned int max_size)
+    : bo_pool(get_userpf_device(handle), max_size)
+  {}
+
+  ~bo_pool()
+  {
+    for (auto& sc : m_classes)
+      for (size_t i = 0; i < m_max_size; ++i)
+        if (sc.slots[i].state == full)
+          sc.slots[i].handle->unmap(sc.slots[i].map);
+  }
+
+  bo_pool(const bo_pool&) = delete;
+  bo_pool(bo_pool&&) = delete;
+  bo_pool& operator=(const bo_pool&) = delete;
+  bo_pool& operator=(bo_pool&&) = delete;
+
+  // get() - Get the pool shared by all users of a device
+  //
+  // The pool keeps the device alive, the registry keeps only a weak
+  // reference to the pool so it is destroyed along with its last user.
+  // The registry entry is removed when the pool is destroyed, so the
+  // registry never refers to a device that has been released.
+  static std::shared_ptr<bo_pool>
+  get(const std::shared_ptr<xrt_core::device>& device, unsigned int max_size)
+  {
+    struct registry
+    {
+      std::mutex mutex;
+      std::map<const xrt_core::device*, std::weak_ptr<bo_pool>> pools;
+    };
+
+    // Pools can outlive the static registry, their deleters refer to it weakly
+    static auto s_registry = std::make_shared<registry>();
+    std::lock_guard lk(s_registry->mutex);
+    auto& wp = s_registry->pools[device.get()];
+    if (auto pool = wp.lock())
+      return pool;
+
+    // A pool replaced by a new pool for the same device before the
+    // deleter ran must not remove the entry of the new pool
+    auto deleter = [key = device.get(), weak = std::weak_ptr<registry>(s_registry)](bo_pool* pool) {
+      if (auto reg = weak.lock()) {
+        std::lock_guard lk(reg->mutex);
+        if (auto itr = reg->pools.find(key); itr != reg->pools.end() && itr->second.expired())
+          reg->pools.erase(itr);
+      }
+      delete pool;
+    };
+
+    auto pool = std::shared_ptr<bo_pool>(new bo_pool(device, max_size), deleter);
+    wp = pool;
+    return pool;
+  }
+
+  template<typename T>
+  cmd_bo<T>
+  alloc(size_t size = min_size)
+  {
+    auto bo = alloc_impl(size);
+    return std::make_pair(std::move(bo.first), static_cast<T *>(bo.second));
+  }
+
+  template<typename T>
+  void
+  release(cmd_bo<T>&& bo, size_t size = min_size)
+  {
+    release_impl(std::make_pair(std::move(bo.first), static_cast<void *>(bo.second)), size);
+  }
+};
+
 } // xrt_core
 
 #ifdef _WIN32
@@ -212,6 +212,22 @@ get_stall_trace()
   return value;
 }
 
+// Format of device trace files: "csv" or "binary"
+inline std::string
+get_device_trace_file_format()
+{
+  static std::string value = detail::get_string_value("Debug.device_trace_file_format", "csv");
+  return value;
+}
+
+// Number of threads decoding PL trace.  0 uses all hardware threads
+inline unsigned int
+get_device_trace_decode_threads()
+{
+  static unsigned int value = detail::get_uint_value("Debug.device_trace_decode_threads", 0);
+  return value;
+}
+
 inline bool
 get_continuous_trace()
 {
@@ -294,6 +310,34 @@ get_native_xrt_trace()
   return value;
 }
 
+// Trace only 1 in N calls of each native XRT API
+inline unsigned int
+get_native_xrt_trace_sample_rate()
+{
+  static unsigned int value = detail::get_uint_value("Debug.native_xrt_trace_sample_rate", 1);
+  return value;
+}
+
+// Trace only native XRT API calls that take at least this long.  Needs
+// an XDP native plugin that provides native_function_complete, with an
+// older plugin the setting is ignored and every call is traced.
+inline unsigned int
+get_native_xrt_trace_min_duration_us()
+{
+  static unsigned int value = detail::get_uint_value("Debug.native_xrt_trace_min_duration_us", 0);
+  return value;
+}
+
+// Comma separated native XRT APIs to trace, for example
+// "xrt::run::start,xrt::bo".  A class or namespace selects all of its
+// functions.  Empty traces all APIs.
+inline std::string
+get_native_xrt_trace_functions()
+{
+  static std::string value = detail::get_string_value("Debug.native_xrt_trace_functions", "");
+  return value;
+}
+
 inline bool
 get_opencl_trace()
 {
@@ -301,6 +345,15 @@ get_opencl_trace()
   return value;
 }
 
+// Keep the duration of every traced API call in addition to the
+// fixed size statistics used for the profile summary
+inline bool
+get_api_call_samples()
+{
+  static bool value = detail::get_bool_value("Debug.api_call_samples", false);
+  return value;
+}
+
 inline bool
 get_device_counters()
 {
@@ -350,6 +403,26 @@ get_use_xclbin_group_sections()
   return value;
 }
 
+// Memory map xclbin files rather than reading them into memory.  The
+// file must not be modified while the xclbin is in use, a process that
+// rewrites a mapped xclbin can crash the application with SIGBUS, so
+// this is opt-in.
+inline bool
+get_xclbin_mmap()
+{
+  static bool value = detail::get_bool_value("Runtime.xclbin_mmap",false);
+  return value;
+}
+
+// Directory of the persistent cache of parsed xclbin and ELF meta
+// data.  The cache is disabled when no directory is specified.
+inline std::string
+get_metadata_cache_dir()
+{
+  static std::string value = detail::get_string_value("Runtime.metadata_cache_dir","");
+  return value;
+}
+
 inline std::string
 get_logging()
 {
@@ -755,6 +828,75 @@ get_device_offline_timer()
   return value;
 }
 
+// Track managed commands in per lane submission order rather than
+// rescanning all running commands each time exec_wait returns.
+// Commands within a lane (same hw context and compute units) are
+// checked from the oldest until one is found to be running.
+inline bool
+get_cmd_completion_lanes()
+{
+  static bool value = detail::get_bool_value("Runtime.cmd_completion_lanes", false);
+  return value;
+}
+
+// Number of threads monitoring managed command execution for all hw
+// queues.  Default 0 uses one monitor thread per hw queue.
+inline unsigned int
+get_cmd_monitor_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.cmd_monitor_threads", 0);
+  return value;
+}
+
+// Comma separated list of cpus to pin command monitor threads to.
+// Thread i is pinned to cpu at index i modulo number of cpus.
+inline std::string
+get_cmd_monitor_cpus()
+{
+  static std::string value = detail::get_string_value("Runtime.cmd_monitor_cpus", "");
+  return value;
+}
+
+// Max time in us to busy poll command state before blocking in
+// exec_wait when waiting for an unmanaged command. The actual spin
+// window adapts to observed command latency.  Default 0 disables
+// busy polling.  Applies to devices that wait through the legacy shim
+// exec_wait only, devices with shim hw queues are not affected.
+inline unsigned int
+get_exec_wait_spin_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_wait_spin_us", 0);
+  return value;
+}
+
+// Max number of command BOs cached per size class in the per
+// device command BO pool.  Value of 0 disables caching.
+inline unsigned int
+get_exec_bo_pool_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_bo_pool_size", 128);
+  return value;
+}
+
+// Size in bytes of chunks when copying buffers through host.  Copies
+// larger than a chunk are pipelined such that syncing from device,
+// host copy, and syncing to device overlap across chunks.
+inline size_t
+get_copy_chunk_size()
+{
+  static size_t value = detail::get_uint_value("Runtime.copy_chunk_size", 16 * 1024 * 1024);
+  return value;
+}
+
+// Number of threads to use for host copy of a chunk when copying
+// buffers through host.
+inline unsigned int
+get_copy_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.copy_threads", 4);
+  return value;
+}
+
 // Configurations under AIE_debug_settings section
 inline std::string
 get_aie_debug_settings_core_registers()
@@ -983,6 +1125,15 @@ get_aie_trace_settings_buffer_offload_interval_us()
   return value;
 }
 
+// Adapt the interval between AIE trace offloads to the rate trace is
+// produced.  The interval only shrinks below buffer_offload_interval_us.
+inline bool
+get_aie_trace_settings_adaptive_offload_interval()
+{
+  static bool value = detail::get_bool_value("AIE_trace_settings.adaptive_offload_interval", false);
+  return value;
+}
+
 inline unsigned int
 get_aie_trace_settings_file_dump_interval_s()
 {
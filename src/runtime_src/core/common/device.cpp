@@ -410,13 +410,14 @@ get_ert_slots(const char* xml_data, size_t xml_size) const
   //  - minimum 2 concurrently scheduled CUs, plus 1 reserved slot
   //  - minimum min_slots
   //  - maximum max_slots
-  auto num_cus = xrt_core::xclbin::get_cus(xml_data, xml_size).size();
+  auto xml = xrt_core::xclbin::get_xml_metadata(xml_data, xml_size);
+  auto num_cus = xrt_core::xclbin::get_cus(*xml).size();
   auto slots = std::min(max_slots, std::max(min_slots, (num_cus * 2) + 1));
 
   // Required slot size bounded by max of
   //  - number of slots needed
   //  - max cu_size per xclbin
-  auto size = std::max(cq_size / slots, xrt_core::xclbin::get_max_cu_size(xml_data, xml_size));
+  auto size = std::max(cq_size / slots, xrt_core::xclbin::get_max_cu_size(*xml));
   slots = cq_size / size;
 
   // Round desired slots to minimum 32, 64, 96, 128 (status register boundary)
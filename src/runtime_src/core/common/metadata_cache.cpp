@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "metadata_cache.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// File layout of a cached blob
+//  magic, format version, blob size, blob hash, blob
+constexpr char magic[8] = { 'X', 'R', 'T', 'M', 'D', 'C', 'A', 'C' };
+constexpr uint32_t format_version = 1;
+
+struct file_header
+{
+  char magic[sizeof(::magic)];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t size;
+  uint64_t hash;
+};
+
+static std::filesystem::path
+get_path(const std::string& key)
+{
+  return std::filesystem::path(xrt_core::config::get_metadata_cache_dir()) / (key + ".bin");
+}
+
+static void
+debug(const std::string& msg)
+{
+  xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT", msg);
+}
+
+} // namespace
+
+namespace xrt_core::metadata_cache {
+
+uint64_t
+hash(const void* data, size_t size, uint64_t seed)
+{
+  constexpr uint64_t prime = 0x100000001b3;
+  auto bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i)
+    seed = (seed ^ bytes[i]) * prime;
+  return seed;
+}
+
+std::string
+make_key(const std::string& kind, const std::string& uuid, uint64_t data_hash)
+{
+  std::ostringstream key;
+  key << kind << '-' << uuid << '-' << std::hex << data_hash;
+  return key.str();
+}
+
+bool
+enabled()
+{
+  return !xrt_core::config::get_metadata_cache_dir().empty();
+}
+
+bool
+load(const std::string& key, std::vector<char>& blob)
+{
+  if (!enabled())
+    return false;
+
+  auto path = get_path(key);
+  std::error_code ec;
+  auto file_size = std::filesystem::file_size(path, ec);
+  if (ec)
+    return false;
+
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  file_header hdr {};
+  if (!ifs.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))
+      || std::memcmp(hdr.magic, magic, sizeof(magic)) != 0
+      || hdr.version != format_version
+      || hdr.size != file_size - sizeof(hdr)) {
+    debug("Ignoring invalid metadata cache entry " + key);
+    return false;
+  }
+
+  blob.resize(hdr.size);
+  if (!ifs.read(blob.data(), static_cast<std::streamsize>(hdr.size))
+      || hash(blob.data(), blob.size()) != hdr.hash) {
+    debug("Ignoring corrupt metadata cache entry " + key);
+    blob.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void
+store(const std::string& key, const std::vector<char>& blob)
+{
+  if (!enabled())
+    return;
+
+  // temporary file name unique across threads and processes
+  static const auto instance = std::random_device{}();
+  static std::atomic<uint32_t> count {0};
+  auto path = get_path(key);
+  std::ostringstream tmp;
+  tmp << path.string() << ".tmp." << std::hex << instance << '.' << count++;
+
+  try {
+    std::filesystem::create_directories(path.parent_path());
+
+    file_header hdr {};
+    std::memcpy(hdr.magic, magic, sizeof(magic));
+    hdr.version = format_version;
+    hdr.size = blob.size();
+    hdr.hash = hash(blob.data(), blob.size());
+
+    {
+      std::ofstream ofs(tmp.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      ofs.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+      ofs.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+      if (!ofs.flush())
+        throw std::runtime_error("write failed");
+    }
+
+    std::filesystem::rename(tmp.str(), path);
+  }
+  catch (const std::exception& ex) {
+    std::error_code ec;
+    std::filesystem::remove(tmp.str(), ec);
+    debug("Failed to store metadata cache entry " + key + ": " + ex.what());
+  }
+}
+
+} // xrt_core::metadata_cache
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef XRT_CORE_METADATA_CACHE_H
+#define XRT_CORE_METADATA_CACHE_H
+
+#include "core/common/config.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Persistent cache of meta data parsed from xclbin and ELF files
+//
+// Parsed meta data is serialized into a compact binary blob that is
+// stored in the directory specified with Runtime.metadata_cache_dir
+// in xrt.ini.  The cache is disabled when no directory is specified.
+//
+// A blob is identified by a key made from the uuid of the xclbin or
+// ELF and a hash of the raw data and xrt.ini settings the meta data
+// depends on, so changes without a new uuid are parsed again.  Blobs are
+// validated when loaded, a blob that fails validation is ignored and
+// replaced when the meta data is stored again.
+namespace xrt_core::metadata_cache {
+
+/**
+ * hash() - 64-bit FNV-1a hash of data
+ *
+ * @data: Data to hash
+ * @size: Size of data
+ * @seed: Hash of preceding data when hashing in pieces
+ */
+XRT_CORE_COMMON_EXPORT
+uint64_t
+hash(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325);  // NOLINT
+
+/**
+ * make_key() - Cache key for meta data
+ *
+ * @kind: Kind of meta data, e.g. "xclbin" or "elf"
+ * @uuid: Uuid of xclbin or ELF as string
+ * @data_hash: Hash of the data the meta data is parsed from
+ */
+XRT_CORE_COMMON_EXPORT
+std::string
+make_key(const std::string& kind, const std::string& uuid, uint64_t data_hash);
+
+/**
+ * enabled() - Check if a cache directory is configured
+ */
+XRT_CORE_COMMON_EXPORT
+bool
+enabled();
+
+/**
+ * load() - Load cached meta data
+ *
+ * @key: Cache key
+ * @blob: Serialized meta data on success
+ * Return: true if a valid blob was found for key
+ */
+XRT_CORE_COMMON_EXPORT
+bool
+load(const std::string& key, std::vector<char>& blob);
+
+/**
+ * store() - Store meta data in cache
+ *
+ * @key: Cache key
+ * @blob: Serialized meta data
+ *
+ * The blob is written to a temporary file that is renamed when
+ * complete, so concurrent processes never see a partial blob.
+ * Failures are not errors, the meta data is just not cached.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+store(const std::string& key, const std::vector<char>& blob);
+
+// class writer - serialize meta data into a blob
+class writer
+{
+  std::vector<char> m_blob;
+
+public:
+  template <typename ValueType>
+  std::enable_if_t<std::is_arithmetic_v<ValueType> || std::is_enum_v<ValueType>>
+  write(ValueType value)
+  {
+    auto data = reinterpret_cast<const char*>(&value);
+    m_blob.insert(m_blob.end(), data, data + sizeof(value));
+  }
+
+  void
+  write(const std::string& str)
+  {
+    write<uint64_t>(str.size());
+    m_blob.insert(m_blob.end(), str.begin(), str.end());
+  }
+
+  [[nodiscard]] const std::vector<char>&
+  get_blob() const
+  {
+    return m_blob;
+  }
+};
+
+// class reader - deserialize meta data from a blob
+//
+// Throws if reading past the end of the blob.
+class reader
+{
+  const char* m_pos;
+  const char* m_end;
+
+  void
+  check(size_t size) const
+  {
+    if (size > static_cast<size_t>(m_end - m_pos))
+      throw std::runtime_error("metadata cache blob is truncated");
+  }
+
+public:
+  explicit reader(const std::vector<char>& blob)
+    : m_pos(blob.data())
+    , m_end(blob.data() + blob.size())
+  {}
+
+  template <typename ValueType>
+  std::enable_if_t<std::is_arithmetic_v<ValueType> || std::is_enum_v<ValueType>, ValueType>
+  read()
+  {
+    ValueType value;
+    check(sizeof(value));
+    std::memcpy(&value, m_pos, sizeof(value));
+    m_pos += sizeof(value);
+    return value;
+  }
+
+  std::string
+  read_string()
+  {
+    auto size = read<uint64_t>();
+    check(size);
+    std::string str(m_pos, size);
+    m_pos += size;
+    return str;
+  }
+
+  [[nodiscard]] bool
+  at_end() const
+  {
+    return m_pos == m_end;
+  }
+};
+
+} // xrt_core::metadata_cache
+
+#endif
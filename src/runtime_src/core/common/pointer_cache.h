@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef core_common_pointer_cache_h
+#define core_common_pointer_cache_h
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xrt_core {
+
+/**
+ * class pointer_cache - lock free map from pointer to value
+ *
+ * @ValueType: Type of cached values, must be default constructible
+ *  and safe for concurrent access (typically atomics)
+ * @table_size: Number of entries, a power of two
+ * @max_probes: Entries probed before a key is considered not to fit
+ *
+ * Meant for keys with static storage duration, such as string
+ * literals identifying call sites.  An entry is claimed the first time
+ * its key is looked up and is never removed, so lookups are a few
+ * atomic loads and nothing is allocated.  A lookup from a thread that
+ * did not claim the entry can see the value before the claiming thread
+ * has set it, values must be usable in their default constructed
+ * state.
+ */
+template <typename ValueType, size_t table_size, size_t max_probes = 16>
+class pointer_cache
+{
+  static_assert((table_size & (table_size - 1)) == 0, "table size must be a power of two");
+
+  struct entry
+  {
+    std::atomic<const void*> key {nullptr};
+    ValueType value {};
+  };
+  std::array<entry, table_size> m_entries;
+
+public:
+  /**
+   * get() - Find or claim the entry for a key
+   *
+   * @key: Key, never nullptr
+   * Return: Value of key, or nullptr if no entry near the key's
+   *  slot is free
+   */
+  ValueType*
+  get(const void* key)
+  {
+    // Fibonacci hash of the address
+    auto hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ULL;
+    auto slot = static_cast<size_t>(hash >> 32);
+
+    for (size_t probe = 0; probe < max_probes; ++probe) {
+      auto& e = m_entries[(slot + probe) & (table_size - 1)];
+      auto current = e.key.load(std::memory_order_acquire);
+      if (current == nullptr
+          && e.key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+        return &e.value;
+
+      // A failed exchange loads the key that claimed the entry
+      if (current == key)
+        return &e.value;
+    }
+    return nullptr;
+  }
+};
+
+} // xrt_core
+
+#endif
@@ -11,6 +11,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace xrt_core {
 
@@ -34,6 +36,9 @@ public:
     device2host = XCL_BO_SYNC_BO_FROM_DEVICE,
   };
 
+  // range - offset and size of a buffer region
+  using range = std::pair<size_t, size_t>;
+
   // properties - buffer details
   struct properties
   {
@@ -67,6 +72,16 @@ public:
   virtual void
   sync(direction, size_t size, size_t offset) = 0;
 
+  // Sync a list of ranges of a buffer to or from device.  The ranges
+  // are sorted by offset and do not overlap.  Shims that can sync
+  // multiple ranges in one driver call should override.
+  virtual void
+  sync_ranges(direction dir, const std::vector<range>& ranges)
+  {
+    for (auto [offset, size] : ranges)
+      sync(dir, size, offset);
+  }
+
   // Copy size bytes from src buffer at src offset into this
   // buffer at dst offset
   virtual void
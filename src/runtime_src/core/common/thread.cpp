@@ -132,6 +132,17 @@ set_cpu_affinity(std::thread& thread)
   }
 }
 
+static void
+set_cpu_affinity(std::thread& thread, unsigned int cpu)
+{
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu,&cpuset);
+  if (pthread_setaffinity_np(thread.native_handle(),sizeof(cpu_set_t),&cpuset)) {
+    throw std::runtime_error("error calling pthread_setaffinity_np");
+  }
+}
+
 #else
 
 static void
@@ -144,6 +155,11 @@ set_cpu_affinity(std::thread&)
 {
 }
 
+static void
+set_cpu_affinity(std::thread&, unsigned int)
+{
+}
+
 #endif
 
 } // platform_specific
@@ -164,6 +180,11 @@ void set_cpu_affinity(std::thread& thread)
   ::platform_specific::set_cpu_affinity(thread);
 }
 
+void set_cpu_affinity(std::thread& thread, unsigned int cpu)
+{
+  ::platform_specific::set_cpu_affinity(thread, cpu);
+}
+
 } // detail
 
 } // xrt_core
@@ -41,6 +41,13 @@ XRT_CORE_COMMON_EXPORT
 void
 set_cpu_affinity(std::thread& thread);
 
+/**
+ * Pin a thread to one specific cpu
+ */
+XRT_CORE_COMMON_EXPORT
+void
+set_cpu_affinity(std::thread& thread, unsigned int cpu);
+
 }
 
 /**
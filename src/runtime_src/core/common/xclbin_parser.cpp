@@ -23,6 +23,7 @@
 #include <regex>
 #include <cstring>
 #include <cstdlib>
+#include <unordered_map>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/range/iterator_range.hpp>
@@ -392,6 +393,84 @@ merge_args(std::vector<xrt_core::xclbin::kernel_argument>& args)
 
 namespace xrt_core { namespace xclbin {
 
+// class xml_metadata - EMBEDDED_METADATA parsed into a property tree
+//
+// The kernel elements are indexed in document order and by name so
+// that per kernel queries do not scan the tree.  The object is not
+// modified after construction.
+class xml_metadata
+{
+  pt::ptree m_project;
+  const pt::ptree* m_core = nullptr;
+  std::vector<const pt::ptree*> m_kernels;
+  std::unordered_map<std::string, const pt::ptree*> m_kernel_index;
+
+public:
+  xml_metadata(const char* xml_data, size_t xml_size)
+  {
+    std::stringstream xml_stream;
+    xml_stream.write(xml_data, xml_size);
+    pt::read_xml(xml_stream, m_project);
+
+    auto core = m_project.get_child_optional("project.platform.device.core");
+    if (!core)
+      return;
+
+    m_core = &core.get();
+    for (auto& xml_kernel : *m_core) {
+      if (xml_kernel.first != "kernel")
+        continue;
+      m_kernels.push_back(&xml_kernel.second);
+      // first kernel element with a given name wins, a kernel
+      // without name is an error only for queries that need it
+      if (auto name = xml_kernel.second.get_optional<std::string>("<xmlattr>.name"))
+        m_kernel_index.emplace(std::move(name.get()), &xml_kernel.second);
+    }
+  }
+
+  const pt::ptree&
+  project() const
+  {
+    return m_project;
+  }
+
+  // Throws pt::ptree_bad_path if the meta data has no kernels
+  // section, same as querying the unparsed XML did
+  const pt::ptree&
+  core() const
+  {
+    return m_core ? *m_core : m_project.get_child("project.platform.device.core");
+  }
+
+  const std::vector<const pt::ptree*>&
+  kernels() const
+  {
+    core(); // throws if no kernel meta data
+    return m_kernels;
+  }
+
+  const pt::ptree*
+  kernel(const std::string& kname) const
+  {
+    core(); // throws if no kernel meta data
+    auto itr = m_kernel_index.find(kname);
+    return itr != m_kernel_index.end() ? itr->second : nullptr;
+  }
+};
+
+std::shared_ptr<const xml_metadata>
+get_xml_metadata(const char* xml_data, size_t xml_size)
+{
+  return std::make_shared<const xml_metadata>(xml_data, xml_size);
+}
+
+std::shared_ptr<const xml_metadata>
+get_xml_metadata(const axlf* top)
+{
+  auto xml = get_xml_section(top);
+  return get_xml_metadata(xml.first, xml.second);
+}
+
 const axlf_section_header*
 get_axlf_section(const axlf* top, axlf_section_kind kind)
 {
@@ -470,24 +549,16 @@ get_first_used_mem(const axlf* top)
 
 // Compute max register map size of CUs in xclbin
 size_t
-get_max_cu_size(const char* xml_data, size_t xml_size)
+get_max_cu_size(const xml_metadata& xml)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
   size_t maxsz = 0;
 
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
-    if (xml_kernel.first != "kernel")
-      continue;
-
+  for (auto xml_kernel : xml.kernels()) {
     // determine address range to ensure args are within
-    size_t address_range = get_address_range(xml_kernel.second);
+    size_t address_range = get_address_range(*xml_kernel);
 
     // iterate arguments and find offset and size to compute max
-    for (auto& xml_arg : xml_kernel.second) {
+    for (auto& xml_arg : *xml_kernel) {
       if (xml_arg.first != "arg")
         continue;
 
@@ -496,7 +567,7 @@ get_max_cu_size(const char* xml_data, size_t xml_size)
 
       // Validate offset and size against address range
       if (ofs + sz > address_range) {
-        auto knm = xml_kernel.second.get<std::string>("<xmlattr>.name");
+        auto knm = xml_kernel->get<std::string>("<xmlattr>.name");
         auto argnm = xml_arg.second.get<std::string>("<xmlattr>.name");
         auto fmt = boost::format
           ("Invalid kernel offset in xclbin for kernel (%s) argument (%s).\n"
@@ -510,6 +581,12 @@ get_max_cu_size(const char* xml_data, size_t xml_size)
   return maxsz;
 }
 
+size_t
+get_max_cu_size(const char* xml_data, size_t xml_size)
+{
+  return get_max_cu_size(*get_xml_metadata(xml_data, xml_size));
+}
+
 std::map<std::string, cuidx_type>
 get_cu_indices(const ip_layout* ip_layout)
 {
@@ -623,19 +700,12 @@ get_cus(const ip_layout* ip_layout, const std::string& kname)
 // Extract CU base addresses for xml meta data
 // Used in sw_emu because IP_LAYOUT section is not available in sw emu.
 std::vector<uint64_t>
-get_cus(const char* xml_data, size_t xml_size, bool)
+get_cus(const xml_metadata& xml)
 {
   std::vector<uint64_t> cus;
 
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data, xml_size);
-  pt::read_xml(xml_stream, xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
-    if (xml_kernel.first != "kernel")
-      continue;
-    for (auto& xml_inst : xml_kernel.second) {
+  for (auto xml_kernel : xml.kernels()) {
+    for (auto& xml_inst : *xml_kernel) {
       if (xml_inst.first != "instance")
         continue;
       for (auto& xml_remap : xml_inst.second) {
@@ -651,6 +721,12 @@ get_cus(const char* xml_data, size_t xml_size, bool)
   return cus;
 }
 
+std::vector<uint64_t>
+get_cus(const char* xml_data, size_t xml_size, bool)
+{
+  return get_cus(*get_xml_metadata(xml_data, xml_size));
+}
+
 std::vector<uint64_t>
 get_cus(const axlf* top, bool encode)
 {
@@ -894,12 +970,8 @@ get_kernel_freq(const axlf* top)
 {
   constexpr size_t default_kernel_clk_freq = 100;
   size_t kernel_clk_freq = default_kernel_clk_freq;
-  auto xml = get_xml_section(top);
-
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml.first,xml.second);
-  pt::read_xml(xml_stream,xml_project);
+  auto xml = get_xml_metadata(top);
+  const auto& xml_project = xml->project();
 
   auto clock_child = xml_project.get_child_optional("project.platform.device.core.kernelClocks");
 
@@ -926,24 +998,14 @@ get_kernel_freq(const axlf* top)
 }
 
 std::vector<kernel_argument>
-get_kernel_arguments(const char* xml_data, size_t xml_size, const std::string& kname)
+get_kernel_arguments(const xml_metadata& xml, const std::string& kname)
 {
   std::vector<kernel_argument> args;
 
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
-    if (xml_kernel.first != "kernel")
-      continue;
-    if (xml_kernel.second.get<std::string>("<xmlattr>.name") != kname)
-      continue;
+  if (auto xml_kernel = xml.kernel(kname)) {
+    auto pwmap = get_portname_width_map(*xml_kernel);
 
-    auto pwmap = get_portname_width_map(xml_kernel.second);
-
-    for (auto& xml_arg : xml_kernel.second) {
+    for (auto& xml_arg : *xml_kernel) {
       if (xml_arg.first != "arg")
         continue;
 
@@ -975,105 +1037,83 @@ get_kernel_arguments(const char* xml_data, size_t xml_size, const std::string& k
 
     // merge args with same index
     merge_args(args);
-
-    break;
   }
   return args;
 }
 
+std::vector<kernel_argument>
+get_kernel_arguments(const char* xml_data, size_t xml_size, const std::string& kname)
+{
+  return get_kernel_arguments(*get_xml_metadata(xml_data, xml_size), kname);
+}
+
 std::vector<kernel_argument>
 get_kernel_arguments(const axlf* top, const std::string& kname)
 {
-  auto xml = get_xml_section(top);
-  return get_kernel_arguments(xml.first, xml.second, kname);
+  return get_kernel_arguments(*get_xml_metadata(top), kname);
 }
 
 kernel_properties
-get_kernel_properties(const char* xml_data, size_t xml_size, const std::string& kname)
+get_kernel_properties(const xml_metadata& xml, const std::string& kname)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
-    if (xml_kernel.first != "kernel")
-      continue;
-    if (xml_kernel.second.get<std::string>("<xmlattr>.name") != kname)
-      continue;
-
+  if (auto xml_kernel = xml.kernel(kname)) {
     // Determine features
-    auto mailbox = convert_to_mailbox_type(xml_kernel.second.get<std::string>("<xmlattr>.mailbox", "none"));
+    auto mailbox = convert_to_mailbox_type(xml_kernel->get<std::string>("<xmlattr>.mailbox", "none"));
     if (mailbox == kernel_properties::mailbox_type::none)
       mailbox = get_mailbox_from_ini(kname);
-    auto restart = convert(xml_kernel.second.get<std::string>("<xmlattr>.countedAutoRestart", "0"));
+    auto restart = convert(xml_kernel->get<std::string>("<xmlattr>.countedAutoRestart", "0"));
     if (restart == 0)
       restart = get_restart_from_ini(kname);
-    auto sw_reset = to_bool(xml_kernel.second.get<std::string>("<xmlattr>.swReset", "false"));
+    auto sw_reset = to_bool(xml_kernel->get<std::string>("<xmlattr>.swReset", "false"));
     if (!sw_reset)
       sw_reset = get_sw_reset_from_ini(kname);
 
-    auto functional = get_functional(xml_kernel.second, "extended-data");
-    auto kernel_id = get_kernel_id(xml_kernel.second, "extended-data");
+    auto functional = get_functional(*xml_kernel, "extended-data");
+    auto kernel_id = get_kernel_id(*xml_kernel, "extended-data");
 
     return kernel_properties
       { kname
-      , to_kernel_type(xml_kernel.second.get<std::string>("<xmlattr>.type", "pl"))
+      , to_kernel_type(xml_kernel->get<std::string>("<xmlattr>.type", "pl"))
       , restart
       , mailbox
-      , get_address_range(xml_kernel.second)
+      , get_address_range(*xml_kernel)
       , sw_reset
       , functional
       , kernel_id
 
-      , convert(xml_kernel.second.get<std::string>("<xmlattr>.workGroupSize", "0"))
-      , get_xyz(xml_kernel.second, "compileWorkGroupSize")
-      , get_xyz(xml_kernel.second, "maxWorkGroupSize")
-      , get_stringtable(xml_kernel.second) };
-
+      , convert(xml_kernel->get<std::string>("<xmlattr>.workGroupSize", "0"))
+      , get_xyz(*xml_kernel, "compileWorkGroupSize")
+      , get_xyz(*xml_kernel, "maxWorkGroupSize")
+      , get_stringtable(*xml_kernel) };
   }
 
   return kernel_properties{};
 }
 
 kernel_properties
-get_kernel_properties(const axlf* top, const std::string& kname)
+get_kernel_properties(const char* xml_data, size_t xml_size, const std::string& kname)
 {
-  auto xml = get_xml_section(top);
-  return get_kernel_properties(xml.first, xml.second, kname);
+  return get_kernel_properties(*get_xml_metadata(xml_data, xml_size), kname);
 }
 
-std::vector<std::string>
-get_kernel_names(const char *xml_data, size_t xml_size)
+kernel_properties
+get_kernel_properties(const axlf* top, const std::string& kname)
 {
-  std::vector<std::string> names;
-
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
-    if (xml_kernel.first != "kernel")
-      continue;
-
-    names.push_back(xml_kernel.second.get<std::string>("<xmlattr>.name"));
-  }
-
-  return names;
+  return get_kernel_properties(*get_xml_metadata(top), kname);
 }
 
 std::vector<kernel_object>
-get_kernels(const char* xml_data, size_t xml_size)
+get_kernels(const xml_metadata& xml)
 {
   std::vector<kernel_object> kernels;
 
-  auto knames = get_kernel_names(xml_data, xml_size);
-  for (auto& kname : get_kernel_names(xml_data, xml_size)) {
-    auto kprop = get_kernel_properties(xml_data, xml_size, kname);
+  for (auto xml_kernel : xml.kernels()) {
+    auto kname = xml_kernel->get<std::string>("<xmlattr>.name");
+    auto kprop = get_kernel_properties(xml, kname);
+    auto args = get_kernel_arguments(xml, kname);
     kernels.emplace_back(kernel_object{
-        kname
-       ,get_kernel_arguments(xml_data, xml_size, kname)
+        std::move(kname)
+       ,std::move(args)
        ,kprop.address_range
        ,kprop.sw_reset
     });
@@ -1082,11 +1122,16 @@ get_kernels(const char* xml_data, size_t xml_size)
   return kernels;
 }
 
+std::vector<kernel_object>
+get_kernels(const char* xml_data, size_t xml_size)
+{
+  return get_kernels(*get_xml_metadata(xml_data, xml_size));
+}
+
 std::vector<kernel_object>
 get_kernels(const axlf* top)
 {
-  auto xml = get_xml_section(top);
-  return get_kernels(xml.first, xml.second);
+  return get_kernels(*get_xml_metadata(top));
 }
 
 // PDI only XCLBIN has PDI section only;
@@ -1112,22 +1157,22 @@ get_vbnv(const axlf* top)
 }
 
 std::string
-get_project_name(const char* xml_data, size_t xml_size)
+get_project_name(const xml_metadata& xml)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  return xml.project().get<std::string>("project.<xmlattr>.name","");
+}
 
-  return xml_project.get<std::string>("project.<xmlattr>.name","");
+std::string
+get_project_name(const char* xml_data, size_t xml_size)
+{
+  return get_project_name(*get_xml_metadata(xml_data, xml_size));
 }
 
 std::string
 get_project_name(const axlf* top)
 {
   try {
-    auto xml = get_xml_section(top);
-    return get_project_name(xml.first, xml.second);
+    return get_project_name(*get_xml_metadata(top));
   }
   catch (const std::exception&) {
     return "";
@@ -1135,14 +1180,15 @@ get_project_name(const axlf* top)
 }
 
 std::string
-get_fpga_device_name(const char* xml_data, size_t xml_size)
+get_fpga_device_name(const xml_metadata& xml)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  return xml.project().get<std::string>("project.platform.device.<xmlattr>.fpgaDevice","");
+}
 
-  return xml_project.get<std::string>("project.platform.device.<xmlattr>.fpgaDevice","");
+std::string
+get_fpga_device_name(const char* xml_data, size_t xml_size)
+{
+  return get_fpga_device_name(*get_xml_metadata(xml_data, xml_size));
 }
 
 }} // xclbin, xrt_core
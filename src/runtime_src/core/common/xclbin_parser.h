@@ -24,6 +24,7 @@
 #include <array>
 #include <limits>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -201,6 +202,37 @@ address_to_memidx(const mem_topology* mem, uint64_t address);
 std::map<std::string, cuidx_type>
 get_cu_indices(const ip_layout* ip_layout);
 
+/**
+ * class xml_metadata - Parsed EMBEDDED_METADATA section
+ *
+ * The XML meta data is parsed once into an immutable object indexed
+ * by kernel name.  The accessors taking raw XML parse the XML on
+ * every call, callers making many queries should get the meta data
+ * once, keep it as long as they need it, and use the overloads taking
+ * xml_metadata.
+ */
+class xml_metadata;
+
+/**
+ * get_xml_metadata() - Parse XML meta data
+ *
+ * @xml_data: XML metadata from xclbin
+ * @xml_size: Size of XML metadata from xclbin
+ * Return: Parsed meta data
+ */
+XRT_CORE_COMMON_EXPORT
+std::shared_ptr<const xml_metadata>
+get_xml_metadata(const char* xml_data, size_t xml_size);
+
+/**
+ * get_xml_metadata() - Parse XML meta data of xclbin
+ *
+ * Throws if the xclbin has no EMBEDDED_METADATA section
+ */
+XRT_CORE_COMMON_EXPORT
+std::shared_ptr<const xml_metadata>
+get_xml_metadata(const axlf* top);
+
 /**
  * get_max_cu_size() - Compute max register map size of CUs in xclbin
  */
@@ -208,6 +240,10 @@ XRT_CORE_COMMON_EXPORT
 size_t
 get_max_cu_size(const char* xml_data, size_t xml_size);
 
+XRT_CORE_COMMON_EXPORT
+size_t
+get_max_cu_size(const xml_metadata& xml);
+
 /**
  * get_cus() - Get sorted list of CU base addresses in xclbin.
  *
@@ -217,6 +253,10 @@ XRT_CORE_COMMON_EXPORT
 std::vector<uint64_t>
 get_cus(const char* xml_data, size_t xml_size, bool encode=false);
 
+XRT_CORE_COMMON_EXPORT
+std::vector<uint64_t>
+get_cus(const xml_metadata& xml);
+
 XRT_CORE_COMMON_EXPORT
 std::vector<uint64_t>
 get_cus(const ip_layout* ip_layout, bool encode=false);
@@ -338,6 +378,10 @@ XRT_CORE_COMMON_EXPORT
 std::vector<kernel_argument>
 get_kernel_arguments(const char* xml_data, size_t xml_size, const std::string& kname);
 
+XRT_CORE_COMMON_EXPORT
+std::vector<kernel_argument>
+get_kernel_arguments(const xml_metadata& xml, const std::string& kname);
+
 
 /**
  * get_kernel_arguments() - Get argument meta data for a kernel
@@ -361,6 +405,10 @@ XRT_CORE_COMMON_EXPORT
 kernel_properties
 get_kernel_properties(const char* xml_data, size_t xml_size, const std::string& kname);
 
+XRT_CORE_COMMON_EXPORT
+kernel_properties
+get_kernel_properties(const xml_metadata& xml, const std::string& kname);
+
 /**
  * get_kernel_properties() -  Get kernel property meta data
  *
@@ -381,6 +429,10 @@ XRT_CORE_COMMON_EXPORT
 std::vector<kernel_object>
 get_kernels(const char* xml_data, size_t xml_size);
 
+XRT_CORE_COMMON_EXPORT
+std::vector<kernel_object>
+get_kernels(const xml_metadata& xml);
+
 /**
  * get_kernels() - Get meta data for all kernels
  *
@@ -411,6 +463,10 @@ XRT_CORE_COMMON_EXPORT
 std::string
 get_project_name(const char* xml_data, size_t xml_size);
 
+XRT_CORE_COMMON_EXPORT
+std::string
+get_project_name(const xml_metadata& xml);
+
 /**
  * get_project_name() - Get the project name from the XML
  */
@@ -424,6 +480,9 @@ get_project_name(const axlf* top);
 std::string
 get_fpga_device_name(const char* xml_data, size_t xml_size);
 
+std::string
+get_fpga_device_name(const xml_metadata& xml);
+
 }} // xclbin, xrt_core
 
 #endif
@@ -738,19 +738,49 @@ out:
 	return ret;
 }
 
+/*
+ * Flush or invalidate CPU cache of a range of a CMA buffer.
+ *
+ * NOTE: We a little bit abuse the dma_sync_single_* API here because
+ *       it is documented as for the DMA buffer mapped by dma_map_*
+ *       API. The buffer we are syncing here is mapped through
+ *       remap_pfn_range(). But so far this is our best choice
+ *       and it works.
+ */
+static int zocl_sync_bo_range(struct drm_device *dev, dma_addr_t bus_addr,
+		enum drm_zocl_sync_bo_dir dir, uint64_t offset, uint64_t size)
+{
+	/* only invalidate the range of addresses requested by the user */
+	bus_addr += offset;
+
+	if (dir == DRM_ZOCL_SYNC_BO_TO_DEVICE) {
+		dma_sync_single_for_device(dev->dev, bus_addr, size,
+		    DMA_TO_DEVICE);
+	} else if (dir == DRM_ZOCL_SYNC_BO_FROM_DEVICE) {
+		dma_sync_single_for_cpu(dev->dev, bus_addr, size,
+		    DMA_FROM_DEVICE);
+	} else
+		return -EINVAL;
+
+	return 0;
+}
+
+static dma_addr_t zocl_bo_bus_addr(struct drm_gem_object *gem_obj)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
+	return to_drm_gem_dma_obj(gem_obj)->dma_addr;
+#else
+	return to_drm_gem_cma_obj(gem_obj)->paddr;
+#endif
+}
+
 int zocl_sync_bo_ioctl(struct drm_device *dev,
 		void *data,
 		struct drm_file *filp)
 {
 	const struct drm_zocl_sync_bo	*args = data;
 	struct drm_gem_object		*gem_obj;
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
-	struct drm_gem_dma_object	*cma_obj;
-#else
-	struct drm_gem_cma_object	*cma_obj;
-#endif
 	struct drm_zocl_bo		*bo;
-	dma_addr_t			bus_addr;
 	int				rc = 0;
 
 	gem_obj = zocl_gem_object_lookup(dev, filp, args->handle);
@@ -772,32 +802,77 @@ int zocl_sync_bo_ioctl(struct drm_device *dev,
 		goto out;
 	}
 
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
-	cma_obj = to_drm_gem_dma_obj(gem_obj);
-	bus_addr = cma_obj->dma_addr;
-#else
-	cma_obj = to_drm_gem_cma_obj(gem_obj);
-	bus_addr = cma_obj->paddr;
-#endif
+	rc = zocl_sync_bo_range(dev, zocl_bo_bus_addr(gem_obj), args->dir,
+	    args->offset, args->size);
 
-	/* only invalidate the range of addresses requested by the user */
-	bus_addr += args->offset;
-
-	/**
-	 * NOTE: We a little bit abuse the dma_sync_single_* API here because
-	 *       it is documented as for the DMA buffer mapped by dma_map_*
-	 *       API. The buffer we are syncing here is mapped through
-	 *       remap_pfn_range(). But so far this is our best choice
-	 *       and it works.
+out:
+	ZOCL_DRM_GEM_OBJECT_PUT_UNLOCKED(gem_obj);
+
+	return rc;
+}
+
+/* Number of ranges copied from user space at a time */
+#define ZOCL_SYNC_RANGES_BATCH	32
+
+int zocl_sync_bo_ranges_ioctl(struct drm_device *dev,
+		void *data,
+		struct drm_file *filp)
+{
+	const struct drm_zocl_sync_bo_ranges	*args = data;
+	struct drm_zocl_sync_bo_range		ranges[ZOCL_SYNC_RANGES_BATCH];
+	struct drm_zocl_sync_bo_range __user	*user_ranges;
+	struct drm_gem_object			*gem_obj;
+	dma_addr_t				bus_addr;
+	uint32_t				done, count, i;
+	bool					coherent;
+	int					rc = 0;
+
+	if (args->pad)
+		return -EINVAL;
+
+	/* No ranges is a noop, used by user space to probe for the ioctl */
+	if (!args->num_ranges)
+		return 0;
+
+	gem_obj = zocl_gem_object_lookup(dev, filp, args->handle);
+	if (!gem_obj) {
+		DRM_ERROR("Failed to look up GEM BO %d\n", args->handle);
+		return -EINVAL;
+	}
+
+	/*
+	 * The CMA buf is coherent, we don't need to do anything after
+	 * validating the ranges
 	 */
-	if (args->dir == DRM_ZOCL_SYNC_BO_TO_DEVICE) {
-		dma_sync_single_for_device(dev->dev, bus_addr, args->size,
-		    DMA_TO_DEVICE);
-	} else if (args->dir == DRM_ZOCL_SYNC_BO_FROM_DEVICE) {
-		dma_sync_single_for_cpu(dev->dev, bus_addr, args->size,
-		    DMA_FROM_DEVICE);
-	} else
-		rc = -EINVAL;
+	coherent = to_zocl_bo(gem_obj)->flags & ZOCL_BO_FLAGS_COHERENT;
+	bus_addr = coherent ? 0 : zocl_bo_bus_addr(gem_obj);
+	user_ranges = to_user_ptr(args->ranges);
+
+	for (done = 0; done < args->num_ranges; done += count) {
+		count = min_t(uint32_t, args->num_ranges - done,
+		    ZOCL_SYNC_RANGES_BATCH);
+		if (copy_from_user(ranges, user_ranges + done,
+		    count * sizeof(ranges[0]))) {
+			rc = -EFAULT;
+			goto out;
+		}
+
+		for (i = 0; i < count; i++) {
+			if ((ranges[i].offset > gem_obj->size) ||
+			    (ranges[i].size > gem_obj->size - ranges[i].offset)) {
+				rc = -EINVAL;
+				goto out;
+			}
+
+			if (coherent)
+				continue;
+
+			rc = zocl_sync_bo_range(dev, bus_addr, args->dir,
+			    ranges[i].offset, ranges[i].size);
+			if (rc)
+				goto out;
+		}
+	}
 
 out:
 	ZOCL_DRM_GEM_OBJECT_PUT_UNLOCKED(gem_obj);
@@ -25,6 +25,8 @@ int zocl_get_hbo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_sync_bo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
+int zocl_sync_bo_ranges_ioctl(struct drm_device *dev, void *data,
+		struct drm_file *filp);
 int zocl_map_bo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_info_bo_ioctl(struct drm_device *dev, void *data,
@@ -69,6 +69,8 @@
  *      context
  * 21   Open graph context                     DRM_IOCTL_ZOCL_OPEN_GRAPH_CTX  drm_zocl_open_graph_ctx
  * 22   Close graph context                    DRM_IOCTL_ZOCL_CLOSE_GRAPH_CTX drm_zocl_close_graph_ctx
+ * 23   Synchronize multiple ranges of buffer  DRM_IOCTL_ZOCL_SYNC_BO_RANGES  drm_zocl_sync_bo_ranges
+ *      in requested direction
  *
  * ==== ====================================== ============================== ==================================
  */
@@ -150,6 +152,8 @@ enum drm_zocl_ops {
 	DRM_ZOCL_AIE_FREQSCALE,
 	/* Set CU read-only range */
 	DRM_ZOCL_SET_CU_READONLY_RANGE,
+	/* Sync multiple ranges of buffer by using CPU cache flushing/invalidation */
+	DRM_ZOCL_SYNC_BO_RANGES,
 	DRM_ZOCL_NUM_IOCTLS
 };
 
@@ -225,6 +229,36 @@ struct drm_zocl_sync_bo {
 	uint64_t size;
 };
 
+/**
+ * struct drm_zocl_sync_bo_range - Range of buffer to synchronize
+ *
+ * @offset:	Offset into the object
+ * @size:	Length of range
+ */
+struct drm_zocl_sync_bo_range {
+	uint64_t offset;
+	uint64_t size;
+};
+
+/**
+ * struct drm_zocl_sync_bo_ranges - Synchronize multiple ranges of the buffer
+ * in the requested direction via cache flush/invalidation.
+ * used with DRM_ZOCL_SYNC_BO_RANGES ioctl.
+ *
+ * @handle:	GEM object handle
+ * @dir:	DRM_ZOCL_SYNC_DIR_XXX
+ * @num_ranges:	Number of entries in ranges array
+ * @pad:	Reserved, must be zero
+ * @ranges:	User pointer to array of struct drm_zocl_sync_bo_range
+ */
+struct drm_zocl_sync_bo_ranges {
+	uint32_t handle;
+	enum drm_zocl_sync_bo_dir dir;
+	uint32_t num_ranges;
+	uint32_t pad;
+	uint64_t ranges;
+};
+
 /**
  * struct drm_zocl_info_bo - Obtain information about buffer object
  * used with DRM_IOCTL_ZOCL_INFO_BO ioctl
@@ -729,4 +763,6 @@ struct drm_zocl_error_inject {
 				       DRM_ZOCL_AIE_FREQSCALE, struct drm_zocl_aie_freq_scale)
 #define DRM_IOCTL_ZOCL_SET_CU_READONLY_RANGE   DRM_IOWR(DRM_COMMAND_BASE + \
 					       DRM_ZOCL_SET_CU_READONLY_RANGE, struct drm_zocl_set_cu_range)
+#define DRM_IOCTL_ZOCL_SYNC_BO_RANGES  DRM_IOWR(DRM_COMMAND_BASE + \
+				       DRM_ZOCL_SYNC_BO_RANGES, struct drm_zocl_sync_bo_ranges)
 #endif
@@ -123,7 +123,12 @@ shim(unsigned index)
   mKernelFD = open(zocl_drm_device.c_str(), O_RDWR);
   // Validity of mKernelFD is checked using handleCheck in every shim function
 
-  mCmdBOCache = std::make_unique<xrt_core::bo_cache>(this, xrt_core::config::get_cmdbo_cache());
+  // Probe for DRM_IOCTL_ZOCL_SYNC_BO_RANGES, a request without ranges
+  // succeeds only if the driver has the ioctl
+  drm_zocl_sync_bo_ranges probe = {};
+  mSyncRangesSupported = (mKernelFD >= 0 && ioctl(mKernelFD, DRM_IOCTL_ZOCL_SYNC_BO_RANGES, &probe) == 0);
+
+  mCmdBOCache = std::make_unique<xrt_core::bo_pool>(this, xrt_core::config::get_cmdbo_cache());
   mDev = zynq_device::get_dev();
 }
 
@@ -457,6 +462,46 @@ xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t off
   return result ? -errno : result;
 }
 
+// Sync all ranges with one ioctl.  If the driver predates
+// DRM_IOCTL_ZOCL_SYNC_BO_RANGES, which is probed when the device is
+// opened, the ranges are synced one ioctl at a time.
+int
+shim::
+xclSyncBORanges(unsigned int boHandle, xclBOSyncDirection dir,
+                const std::vector<std::pair<size_t, size_t>>& ranges)
+{
+  if (mSyncRangesSupported) {
+    drm_zocl_sync_bo_dir zocl_dir;
+    if (dir == XCL_BO_SYNC_BO_TO_DEVICE)
+      zocl_dir = DRM_ZOCL_SYNC_BO_TO_DEVICE;
+    else if (dir == XCL_BO_SYNC_BO_FROM_DEVICE)
+      zocl_dir = DRM_ZOCL_SYNC_BO_FROM_DEVICE;
+    else
+      return -EINVAL;
+
+    std::vector<drm_zocl_sync_bo_range> zocl_ranges;
+    zocl_ranges.reserve(ranges.size());
+    for (auto [offset, size] : ranges)
+      zocl_ranges.push_back({offset, size});
+
+    drm_zocl_sync_bo_ranges syncInfo = { boHandle, zocl_dir,
+      static_cast<uint32_t>(zocl_ranges.size()), 0,
+      reinterpret_cast<uint64_t>(zocl_ranges.data()) };
+    int result = ioctl(mKernelFD, DRM_IOCTL_ZOCL_SYNC_BO_RANGES, &syncInfo);
+
+    xclLog(XRT_DEBUG, "%s: boHandle %d, dir %d, ranges %zu", __func__, boHandle, dir, ranges.size());
+    xclLog(XRT_INFO, "%s: ioctl return %d", __func__, result);
+
+    return result ? -errno : result;
+  }
+
+  for (auto [offset, size] : ranges)
+    if (auto ret = xclSyncBO(boHandle, dir, size, offset))
+      return ret;
+
+  return 0;
+}
+
 int
 shim::
 xclCopyBO(unsigned int dst_boHandle, unsigned int src_boHandle, size_t size,
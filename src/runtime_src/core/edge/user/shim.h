@@ -157,6 +157,12 @@ public:
       m_shim->xclSyncBO(m_hdl, static_cast<xclBOSyncDirection>(dir), size, offset);
     }
 
+    void
+    sync_ranges(direction dir, const std::vector<range>& ranges) override
+    {
+      m_shim->xclSyncBORanges(m_hdl, static_cast<xclBOSyncDirection>(dir), ranges);
+    }
+
     void
     copy(const buffer_handle* src, size_t size, size_t dst_offset, size_t src_offset) override
     {
@@ -308,6 +314,8 @@ public:
 
   int xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size,
                 size_t offset);
+  int xclSyncBORanges(unsigned int boHandle, xclBOSyncDirection dir,
+                      const std::vector<std::pair<size_t, size_t>>& ranges);
   int xclCopyBO(unsigned int dst_boHandle, unsigned int src_boHandle, size_t size,
                 size_t dst_offset, size_t src_offset);
 
@@ -363,10 +371,11 @@ private:
   std::ifstream mVBNV;
   int mKernelFD;
   static std::map<uint64_t, uint32_t *> mKernelControl;
-  std::unique_ptr<xrt_core::bo_cache> mCmdBOCache;
+  std::unique_ptr<xrt_core::bo_pool> mCmdBOCache;
   zynq_device *mDev = nullptr;
   size_t mKernelClockFreq;
   bool hw_context_enable = false;
+  bool mSyncRangesSupported = false; // zocl has SYNC_BO_RANGES, probed at open
 
   /*
    * Mapped CU register space for xclRegRead/Write(). We support at most
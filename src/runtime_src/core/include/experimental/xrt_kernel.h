@@ -12,6 +12,7 @@
 # include "xrt/detail/pimpl.h"
 # include <chrono>
 # include <condition_variable>
+# include <vector>
 #endif
 
 #ifdef __cplusplus
@@ -34,6 +35,10 @@ namespace xrt {
  * list can be reused by calling execute() again maybe with additional
  * run objects.
  *
+ * Fence waits and signals can be added to the list in between run
+ * objects.  The list is replayed including the fences each time it
+ * is executed.
+ *
  * There is no support for removing individual run objects from the
  * list.
  */
@@ -138,6 +143,42 @@ public:
   void
   add(const xrt::run& run);
 
+  /**
+   * submit_wait() - Add a fence wait to the list
+   *
+   * @param fence
+   *  Fence to wait for
+   *
+   * The fence wait is recorded at the current end of the list.  When
+   * the list is executed, run objects added after the fence wait are
+   * not executed until the fence is signaled.
+   *
+   * A runlist records run objects and fences once, and replays them
+   * each time the list is executed.  The argument values of run
+   * objects can be changed between executions.
+   *
+   * Throws if runlist is executing.
+   */
+  XRT_API_EXPORT
+  void
+  submit_wait(const xrt::fence& fence);
+
+  /**
+   * submit_signal() - Add a fence signal to the list
+   *
+   * @param fence
+   *  Fence to signal
+   *
+   * The fence signal is recorded at the current end of the list.
+   * When the list is executed, the fence is signaled when all run
+   * objects added before the fence signal have completed.
+   *
+   * Throws if runlist is executing.
+   */
+  XRT_API_EXPORT
+  void
+  submit_signal(const xrt::fence& fence);
+
   /**
    * execute() - Execute the runlist
    *
@@ -225,8 +266,8 @@ public:
   /**
    * reset() - Reset the runlist
    *
-   * The runlist is reset to its initial state. All run objects are
-   * removed from the list.
+   * The runlist is reset to its initial state. All run objects and
+   * fences are removed from the list.
    *
    * It is the caller's responsibility to ensure that the runlist is
    * not executing when this method is called.  This can be done by
@@ -239,6 +280,27 @@ public:
   reset();
 };
 
+/**
+ * start() - Start a batch of run objects
+ *
+ * @param runs
+ *  The run objects to start
+ *
+ * Same as calling xrt::run::start() on each run object, but the
+ * host side submission overhead, e.g. completion tracking of managed
+ * runs, is amortized over the batch.  Run objects that share a
+ * hardware queue are submitted in the order in which they appear in
+ * the batch.
+ *
+ * All run objects are validated before any run object is modified
+ * or started.  The function throws without starting any run object
+ * if a run object is still running, appears more than once in the
+ * batch, or is part of a runlist.
+ */
+XRT_API_EXPORT
+void
+start(const std::vector<xrt::run>& runs);
+
 } // namespace xrt
 
 #endif // __cplusplus
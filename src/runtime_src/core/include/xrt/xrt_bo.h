@@ -11,6 +11,8 @@
 
 #ifdef __cplusplus
 # include <memory>
+# include <utility>
+# include <vector>
 #endif
 
 /**
@@ -586,6 +588,48 @@ public:
     sync(dir, size(), 0);
   }
 
+  /**
+   * sync() - Synchronize multiple ranges of buffer with device side
+   *
+   * @param dir
+   *  To device or from device
+   * @param ranges
+   *  List of (offset, size) pairs of the ranges to synchronize
+   *
+   * Sync the specified ranges of the buffer.  The ranges can be in
+   * any order, adjacent and overlapping ranges are coalesced before
+   * synchronizing.  This is more efficient than one sync() call per
+   * range, when supported by the driver all ranges are synchronized
+   * in one call.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync(xclBOSyncDirection dir, const std::vector<std::pair<size_t, size_t>>& ranges);
+
+  /**
+   * sync_2d() - Synchronize a 2D region of buffer with device side
+   *
+   * @param dir
+   *  To device or from device
+   * @param width
+   *  Number of bytes to synchronize in each row
+   * @param height
+   *  Number of rows to synchronize
+   * @param stride
+   *  Number of bytes between start of consecutive rows
+   * @param offset
+   *  Offset within the BO of first byte of first row
+   *
+   * Sync a sub-window of a buffer holding 2D data, e.g. a tile of
+   * an image.  Equivalent to sync() with one range per row.
+   *
+   * Throws if width is larger than stride or if the window extends
+   * past the end of the buffer.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync_2d(xclBOSyncDirection dir, size_t width, size_t height, size_t stride, size_t offset);
+
   /**
    * map() - Map the host side buffer into application
    *
@@ -723,6 +767,28 @@ public:
     copy(src, src.size());
   }
 
+  /**
+   * async_copy() - Start deep copy of BO content from another buffer
+   *
+   * @param src
+   *  Source BO to copy from
+   * @param sz
+   *  Size of data to copy
+   * @param src_offset
+   *  Offset into src buffer copy from
+   * @param dst_offset
+   *  Offset into this buffer to copy to
+   * @return
+   *  Handle to wait for the copy to complete
+   *
+   * Same as copy() but the copy is performed asynchronously.  Any
+   * error is reported when waiting on the returned handle.  The
+   * buffers must not be modified until the copy has completed.
+   */
+  XCL_DRIVER_DLLESPEC
+  async_handle
+  async_copy(const bo& src, size_t sz, size_t src_offset=0, size_t dst_offset=0);
+
   /**
    * ~bo() - Destructor for bo object
    */
@@ -256,6 +256,12 @@ namespace xdp {
     return device_db->getAIETraceData(strmIndex);
   }
 
+  void VPDynamicDatabase::releaseAIETraceData(uint64_t deviceId, aie::TraceDataType* data)
+  {
+    auto device_db = getDeviceDB(deviceId);
+    device_db->releaseAIETraceData(data);
+  }
+
   void VPDynamicDatabase::addPowerSample(uint64_t deviceId, double timestamp,
           const std::vector<uint64_t>& values)
   {
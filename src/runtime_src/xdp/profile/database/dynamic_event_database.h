@@ -131,6 +131,11 @@ namespace xdp {
     inline uint64_t addString(const std::string& value)
     { return stringTable.addString(value); }
 
+    // A lookup of a string with static storage duration, such as an
+    // API name literal.  Lock free after the first lookup of the string.
+    inline uint64_t addStaticString(const char* value)
+    { return stringTable.addStaticString(value); }
+
     // A function that iterates on the dynamic events and returns
     // copies of the events based upon the filter passed in
     XDP_CORE_EXPORT
@@ -166,6 +171,7 @@ namespace xdp {
     // Add and get AIE Trace Data Buffer 
     XDP_CORE_EXPORT void addAIETraceData(uint64_t deviceId, uint64_t strmIndex, void* buffer, uint64_t bufferSz, bool copy);
     XDP_CORE_EXPORT aie::TraceDataType* getAIETraceData(uint64_t deviceId, uint64_t strmIndex);
+    XDP_CORE_EXPORT void releaseAIETraceData(uint64_t deviceId, aie::TraceDataType* data);
 
     // Functions that are used by counter-based plugins
     XDP_CORE_EXPORT void addPowerSample(uint64_t deviceId, double timestamp,
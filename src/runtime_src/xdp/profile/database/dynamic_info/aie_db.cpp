@@ -16,6 +16,7 @@
 
 #define XDP_CORE_SOURCE
 
+#include <algorithm>
 #include <cstring>
 
 #include "core/common/message.h"
@@ -28,9 +29,18 @@ namespace xdp {
   {
     std::lock_guard<std::mutex> lock(traceLock);
 
-    for (auto info : traceData)
+    for (auto info : traceData) {
+      if (info && info->owner) {
+        for (auto buf : info->buffer)
+          delete[] buf;
+      }
       delete info;
+    }
     traceData.clear();
+
+    for (auto buf : freeHostBuffers)
+      delete[] buf;
+    freeHostBuffers.clear();
   }
 
   void AIEDB::addAIETraceData(uint64_t strmIndex, void* buffer,
@@ -45,18 +55,42 @@ namespace xdp {
     if (traceData.size() == 0)
       traceData.resize(numTraceStreams);
 
-    if (traceData[strmIndex] == nullptr)
+    if (traceData[strmIndex] == nullptr) {
       traceData[strmIndex] = new aie::TraceDataType;
+      traceData[strmIndex]->owner = copy;
+    }
+
+    auto data = traceData[strmIndex];
+    if (!copy) {
+      data->buffer.push_back(static_cast<unsigned char*>(buffer));
+      data->bufferSz.push_back(bufferSz);
+      return;
+    }
 
-    unsigned char* trace_buffer = static_cast<unsigned char*>(buffer);
-    if (copy) {
-      // We need to copy data as it may be overwritten by datamover
-      trace_buffer = new unsigned char[bufferSz];
-      std::memcpy(trace_buffer, buffer, bufferSz);
+    // We need to copy data as it may be overwritten by datamover.
+    //  Fill up the last host buffer before starting another one.
+    auto source = static_cast<const unsigned char*>(buffer);
+    while (bufferSz > 0) {
+      if (data->buffer.empty() || data->bufferSz.back() == hostBufferSize) {
+        unsigned char* hostBuffer = nullptr;
+        if (freeHostBuffers.empty()) {
+          hostBuffer = new unsigned char[hostBufferSize];
+        }
+        else {
+          hostBuffer = freeHostBuffers.back();
+          freeHostBuffers.pop_back();
+        }
+        data->buffer.push_back(hostBuffer);
+        data->bufferSz.push_back(0);
+      }
+
+      uint64_t& used = data->bufferSz.back();
+      uint64_t bytes = std::min(bufferSz, hostBufferSize - used);
+      std::memcpy(data->buffer.back() + used, source, bytes);
+      used += bytes;
+      source += bytes;
+      bufferSz -= bytes;
     }
-    traceData[strmIndex]->buffer.push_back(trace_buffer);
-    traceData[strmIndex]->bufferSz.push_back(bufferSz);
-    traceData[strmIndex]->owner = copy;
   }
 
   aie::TraceDataType* AIEDB::getAIETraceData(uint64_t strmIndex)
@@ -67,10 +101,27 @@ namespace xdp {
       return nullptr;
 
     auto data = traceData[strmIndex];
-    traceData[strmIndex] = new aie::TraceDataType;
+    traceData[strmIndex] = nullptr;
     return data;
   }
 
+  void AIEDB::releaseAIETraceData(aie::TraceDataType* data)
+  {
+    if (data == nullptr)
+      return;
+
+    if (data->owner) {
+      std::lock_guard<std::mutex> lock(traceLock);
+      for (auto buf : data->buffer) {
+        if (freeHostBuffers.size() < maxFreeHostBuffers)
+          freeHostBuffers.push_back(buf);
+        else
+          delete[] buf;
+      }
+    }
+    delete data;
+  }
+
   void AIEDB::addAIESample(double timestamp, const std::vector<uint64_t>& values)
   {
       samples.addSample({timestamp, values});
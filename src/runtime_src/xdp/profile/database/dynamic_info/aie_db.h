@@ -35,10 +35,18 @@ namespace xdp {
   private:
     aie::TraceDataVector traceData;
 
+    // Trace that has to be copied is appended to fixed size host
+    //  buffers.  The writer returns them once the trace is written, so
+    //  in steady state offload allocates nothing.  Every offloaded byte
+    //  is still copied once; this is not a zero copy scheme.
+    static constexpr uint64_t hostBufferSize = 0x100000; // 1 MB
+    static constexpr size_t maxFreeHostBuffers = 16;
+    std::vector<unsigned char*> freeHostBuffers;
+
     SampleContainer samples;
     DoubleSampleContainer timerSamples;
 
-    std::mutex traceLock; // Protects "traceData" vector
+    std::mutex traceLock; // Protects "traceData" and "freeHostBuffers"
 
     // This is the amount of AIESample threshold AIEDB stores before it flushes to the disk
     static constexpr uint64_t sampleThreshold = 100000;
@@ -50,6 +58,7 @@ namespace xdp {
     void addAIETraceData(uint64_t strmIndex, void* buffer, uint64_t bufferSz,
                          bool copy, uint64_t numTraceStreams);
     aie::TraceDataType* getAIETraceData(uint64_t strmIndex);
+    void releaseAIETraceData(aie::TraceDataType* data);
 
     void addAIESample(double timestamp, const std::vector<uint64_t>& values);
 
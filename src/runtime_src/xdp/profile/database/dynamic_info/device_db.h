@@ -103,6 +103,9 @@ namespace xdp {
     inline aie::TraceDataType* getAIETraceData(uint64_t strmIndex)
     { return aie_db.getAIETraceData(strmIndex); }
 
+    inline void releaseAIETraceData(aie::TraceDataType* data)
+    { aie_db.releaseAIETraceData(data); }
+
     inline
     void addAIESample(double timestamp, const std::vector<uint64_t>& values)
     { aie_db.addAIESample(timestamp, values);  }
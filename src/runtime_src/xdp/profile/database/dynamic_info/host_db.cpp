@@ -19,6 +19,9 @@
 #include "xdp/profile/database/dynamic_info/host_db.h"
 #include "xdp/profile/database/events/vtf_event.h"
 #include <algorithm>
+#include <numeric>
+#include <queue>
+#include <tuple>
 
 namespace xdp {
 
@@ -27,9 +30,9 @@ namespace xdp {
     // Delete sorted events still in the database and not moved
     {
       std::lock_guard<std::mutex> lock(sortedLock);
-      for (auto& iter : sortedEvents) {
-        auto event = iter.second;
-        delete event;
+      for (auto& chunk : sortedEvents) {
+        for (auto event : chunk.events)
+          delete event;
       }
     }
     // Delete unsorted events still in the database and not moved
@@ -45,8 +48,76 @@ namespace xdp {
     if (event == nullptr)
       return;
 
+    auto timestamp = event->getTimestamp();
+
     std::lock_guard<std::mutex> lock(sortedLock);
-    sortedEvents.emplace(event->getTimestamp(), event);
+    if (sortedEvents.empty() || sortedEvents.back().events.size() >= chunkSize)
+      sortedEvents.emplace_back();
+
+    auto& chunk = sortedEvents.back();
+    if (!chunk.timestamps.empty() && timestamp < chunk.timestamps.back())
+      chunk.sorted = false;
+    chunk.timestamps.push_back(timestamp);
+    chunk.events.push_back(event);
+  }
+
+  template <typename VectorType>
+  void HostDB::trimCapacity(VectorType& vec)
+  {
+    if (vec.capacity() > retainedCapacity && vec.size() < vec.capacity() / 4)
+      vec.shrink_to_fit();
+  }
+
+  void HostDB::sortChunk(EventChunk& chunk)
+  {
+    if (chunk.sorted)
+      return;
+
+    // Stable so that events with equal timestamps keep the order
+    // they were added in
+    std::vector<size_t> order(chunk.events.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&chunk](size_t a, size_t b) {
+      return chunk.timestamps[a] < chunk.timestamps[b];
+    });
+
+    std::vector<double> timestamps;
+    std::vector<VTFEvent*> events;
+    timestamps.reserve(chunk.timestamps.capacity());
+    events.reserve(chunk.events.capacity());
+    for (auto i : order) {
+      timestamps.push_back(chunk.timestamps[i]);
+      events.push_back(chunk.events[i]);
+    }
+    chunk.timestamps.swap(timestamps);
+    chunk.events.swap(events);
+    chunk.sorted = true;
+  }
+
+  template <typename Visit>
+  void HostDB::mergeChunks(Visit&& visit)
+  {
+    for (auto& chunk : sortedEvents)
+      sortChunk(chunk);
+
+    // Earlier chunks hold earlier added events, so ties on the
+    // timestamp are broken by the chunk index
+    using Head = std::tuple<double, size_t, size_t>; // timestamp, chunk, position
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t c = 0; c < sortedEvents.size(); ++c) {
+      if (!sortedEvents[c].events.empty())
+        heads.emplace(sortedEvents[c].timestamps[0], c, 0);
+    }
+
+    while (!heads.empty()) {
+      auto [timestamp, c, position] = heads.top();
+      heads.pop();
+
+      auto& chunk = sortedEvents[c];
+      visit(chunk, position);
+      if (++position < chunk.events.size())
+        heads.emplace(chunk.timestamps[position], c, position);
+    }
   }
 
   void HostDB::addUnsortedEvent(VTFEvent* event)
@@ -61,10 +132,11 @@ namespace xdp {
   bool HostDB::sortedEventsExist(std::function<bool (VTFEvent*)>& filter)
   {
     std::lock_guard<std::mutex> lock(sortedLock);
-    for (auto& iter : sortedEvents) {
-      auto event = iter.second;
-      if (filter(event))
-        return true;
+    for (auto& chunk : sortedEvents) {
+      for (auto event : chunk.events) {
+        if (filter(event))
+          return true;
+      }
     }
     return false;
   }
@@ -75,11 +147,11 @@ namespace xdp {
     std::lock_guard<std::mutex> lock(sortedLock);
 
     std::vector<VTFEvent*> collected;
-    for (auto& iter : sortedEvents) {
-      auto event = iter.second;
+    mergeChunks([&filter, &collected](EventChunk& chunk, size_t position) {
+      auto event = chunk.events[position];
       if (filter(event))
         collected.push_back(event);
-    }
+    });
     return collected;
   }
 
@@ -103,15 +175,45 @@ namespace xdp {
 
     std::vector<std::unique_ptr<VTFEvent>> collected;
 
-    for (auto iter = sortedEvents.begin(); iter != sortedEvents.end(); ) {
-      auto event = (*iter).second;
+    // Moved events are cleared in place and removed from the chunks
+    // afterwards so the merge positions stay valid
+    mergeChunks([&filter, &collected](EventChunk& chunk, size_t position) {
+      auto& event = chunk.events[position];
       if (filter(event)) {
         collected.emplace_back(event);
-        iter = sortedEvents.erase(iter);
+        event = nullptr;
+      }
+    });
+
+    if (collected.empty())
+      return collected;
+
+    for (auto& chunk : sortedEvents) {
+      size_t kept = 0;
+      for (size_t i = 0; i < chunk.events.size(); ++i) {
+        if (chunk.events[i] == nullptr)
+          continue;
+        chunk.timestamps[kept] = chunk.timestamps[i];
+        chunk.events[kept] = chunk.events[i];
+        ++kept;
+      }
+      chunk.timestamps.resize(kept);
+      chunk.events.resize(kept);
+
+      // Only the last chunk receives new events, earlier chunks that
+      // were mostly drained give back their memory
+      if (&chunk != &sortedEvents.back() && kept < chunkSize / 4) {
+        chunk.timestamps.shrink_to_fit();
+        chunk.events.shrink_to_fit();
       }
-      else
-        ++iter;
     }
+
+    // Drop the chunks that were emptied
+    auto newEnd = std::remove_if(sortedEvents.begin(), sortedEvents.end(),
+                                 [](const EventChunk& chunk) {
+                                   return chunk.events.empty();
+                                 });
+    sortedEvents.erase(newEnd, sortedEvents.end());
     return collected;
   }
 
@@ -132,6 +234,7 @@ namespace xdp {
 
     // Resize the UnsortedEvents vector to keep only the remaining unfiltered events
     unsortedEvents.erase(newEnd, unsortedEvents.end());
+    trimCapacity(unsortedEvents);
 
     return collected;
   }
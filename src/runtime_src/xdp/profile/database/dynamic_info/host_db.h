@@ -42,8 +42,44 @@ namespace xdp {
     static constexpr uint64_t eventThreshold = 10000000;
 
     // Before all events are printed in a CSV, they have to be sorted.
-    // The multimap sorts them as we create and insert them.
-    std::multimap<double, VTFEvent*> sortedEvents;
+    // Events are appended to fixed size chunks that store timestamps
+    // and events in separate arrays.  Host events arrive nearly in
+    // timestamp order, so each chunk is sorted on its own and the
+    // chunks are merged when the events are read out.  Compared to a
+    // tree node per event, this keeps insertion constant time and the
+    // overhead at the two array entries per event.
+    static constexpr size_t chunkSize = 16384;
+
+    struct EventChunk
+    {
+      std::vector<double> timestamps;
+      std::vector<VTFEvent*> events;
+      bool sorted = true;
+
+      EventChunk()
+      {
+        timestamps.reserve(chunkSize);
+        events.reserve(chunkSize);
+      }
+    };
+    std::vector<EventChunk> sortedEvents;
+
+    void sortChunk(EventChunk& chunk);
+
+    // Capacity kept by a vector that was partially drained, so memory
+    // used for a burst of events is returned once the events are moved
+    // out.  A vector holding less than a quarter of its capacity, and
+    // more than retainedCapacity, is shrunk.
+    static constexpr size_t retainedCapacity = chunkSize;
+
+    template <typename VectorType>
+    static void trimCapacity(VectorType& vec);
+
+    // Visit all events in timestamp order across all chunks, with
+    // events of equal timestamps visited in the order they were added.
+    // The visitor gets the chunk and the position of each event.
+    template <typename Visit>
+    void mergeChunks(Visit&& visit);
 
     // For host events that will be sorted later (when printed), we
     // can store them away in a simple vector
@@ -69,7 +105,7 @@ namespace xdp {
     // Different host layers can have dependencies between events
     DependencyManager openclDependencies;
 
-    std::mutex sortedLock; // Protects the "sortedEvents" multimap
+    std::mutex sortedLock; // Protects the "sortedEvents" chunks
     std::mutex unsortedLock; // Protects the "unsortedEvents" vector
 
   public:
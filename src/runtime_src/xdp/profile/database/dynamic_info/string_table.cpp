@@ -16,6 +16,10 @@
 
 #define XDP_CORE_SOURCE
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "xdp/profile/database/dynamic_info/string_table.h"
 
 namespace xdp {
@@ -24,18 +28,43 @@ namespace xdp {
   {
     std::lock_guard<std::mutex> lock(dataLock);
 
-    if (table.find(value) == table.end())
-      table[value] = currentId++;
+    auto [itr, inserted] = table.emplace(value, currentId);
+    if (inserted)
+      ++currentId;
 
-    return table[value];
+    return itr->second;
+  }
+
+  uint64_t StringTable::addStaticString(const char* value)
+  {
+    auto cached = staticCache.get(value);
+    if (!cached) // Cache is crowded around this slot
+      return addString(value);
+
+    if (auto id = cached->load(std::memory_order_acquire))
+      return id;
+
+    // First lookup, or another thread is still adding the string.
+    //  addString returns the same id either way.
+    auto id = addString(value);
+    cached->store(id, std::memory_order_release);
+    return id;
   }
 
   void StringTable::dumpTable(std::ofstream& fout)
   {
     std::lock_guard<std::mutex> lock(dataLock);
 
+    // The table is unordered, dump in order of id so the output
+    // is deterministic
+    std::vector<std::pair<uint64_t, const std::string*>> sorted;
+    sorted.reserve(table.size());
     for (auto& s : table)
-      fout << s.second << "," << s.first.c_str() << "\n";
+      sorted.emplace_back(s.second, &s.first);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (auto& s : sorted)
+      fout << s.first << "," << s.second->c_str() << "\n";
   }
 
 } // end namespace xdp
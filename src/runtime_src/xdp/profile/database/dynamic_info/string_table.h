@@ -17,12 +17,14 @@
 #ifndef STRING_TABLE_DOT_H
 #define STRING_TABLE_DOT_H
 
+#include <atomic>
 #include <cstdint>
 #include <fstream>
-#include <map>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
+#include "core/common/pointer_cache.h"
 #include "xdp/config.h"
 
 namespace xdp {
@@ -30,15 +32,29 @@ namespace xdp {
   class StringTable
   {
   private:
-    std::map<std::string, uint64_t> table;
+    std::unordered_map<std::string, uint64_t> table;
     uint64_t currentId = 1; // Start at 1 so we can use 0 as a special value
 
     std::mutex dataLock; // Protects "table" map and currentId
+
+    // Strings with static storage duration, such as the API names
+    // passed by the XRT profiling callbacks, are looked up by address
+    // in this lock free cache before falling back to "table".  Each
+    // call site's name is interned once and subsequent lookups are a
+    // few atomic loads.  An id of 0 is not set yet.
+    xrt_core::pointer_cache<std::atomic<uint64_t>, 4096> staticCache;
+
   public:
     StringTable() = default;
     ~StringTable() = default;
 
     XDP_CORE_EXPORT uint64_t addString(const std::string& value);
+
+    // Same as addString, but the string must have static storage
+    // duration (for example a string literal) as it is cached by
+    // address.  Returns the same id as addString for equal strings.
+    XDP_CORE_EXPORT uint64_t addStaticString(const char* value);
+
     XDP_CORE_EXPORT void dumpTable(std::ofstream& fout);
   };
 
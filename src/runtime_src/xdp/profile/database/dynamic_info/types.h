@@ -73,11 +73,15 @@ namespace xdp::counters {
 
 namespace xdp::aie {
 
+  // Trace offloaded from one AIE trace stream.  If owner is set, the
+  //  buffers were allocated by the database and must be returned with
+  //  releaseAIETraceData once written.  Otherwise they point into the
+  //  mapped device buffer.
   struct TraceDataType
   {
     std::vector<unsigned char *> buffer;
     std::vector<uint64_t> bufferSz;
-    bool owner;
+    bool owner = false;
   };
 
   typedef std::vector<TraceDataType*> TraceDataVector;
@@ -36,7 +36,7 @@ namespace xdp {
   NativeSyncRead::NativeSyncRead(uint64_t s_id, double ts, uint64_t name) :
     NativeAPICall(s_id, ts, name)
   {
-    readStr = VPDatabase::Instance()->getDynamicInfo().addString("READ");
+    readStr = VPDatabase::Instance()->getDynamicInfo().addStaticString("READ");
   }
 
   void NativeSyncRead::dumpSync(std::ofstream& fout, uint32_t bucket)
@@ -48,7 +48,7 @@ namespace xdp {
   NativeSyncWrite::NativeSyncWrite(uint64_t s_id, double ts, uint64_t name) :
     NativeAPICall(s_id, ts, name)
   {
-    writeStr = VPDatabase::Instance()->getDynamicInfo().addString("WRITE");
+    writeStr = VPDatabase::Instance()->getDynamicInfo().addStaticString("WRITE");
   }
 
   void NativeSyncWrite::dumpSync(std::ofstream& fout, uint32_t bucket)
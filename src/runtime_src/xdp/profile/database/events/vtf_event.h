@@ -90,7 +90,6 @@ namespace xdp {
     VTFEventType type ; // For quick lookup
 
     virtual void dumpTimestamp(std::ofstream& fout) ;
-    void dumpType(std::ofstream& fout, bool humanReadable) ;
 
   public:
     XDP_CORE_EXPORT VTFEvent(uint64_t s_id, double ts, VTFEventType ty) ;
@@ -100,6 +99,7 @@ namespace xdp {
     inline double       getTimestamp()    const { return timestamp ; }
     inline void         setTimestamp(double ts) { timestamp = ts ; }
     inline uint64_t     getEventId()            { return id ; }
+    inline uint64_t     getStartId()            { return start_id ; }
     inline void         setEventId(uint64_t i)  { id = i ; }
     inline VTFEventType getEventType()          { return type; }
 
@@ -135,6 +135,7 @@ namespace xdp {
 
     virtual uint64_t getDevice() { return 0 ; } // CHECK
     XDP_CORE_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_CORE_EXPORT void dumpType(std::ofstream& fout, bool humanReadable) ;
     virtual void dumpSync(std::ofstream& /*fout*/, uint32_t /*bucket*/) {};
   } ;
 
@@ -22,11 +22,13 @@
 #define XDP_CORE_SOURCE
 
 #include "xdp/profile/database/statistics_database.h"
+#include "core/common/config_reader.h"
 
 namespace xdp {
 
   VPStatisticsDatabase::VPStatisticsDatabase(VPDatabase* d) :
-    db(d), numMigrateMemCalls(0), numHostP2PTransfers(0),
+    db(d), keepCallSamples(xrt_core::config::get_api_call_samples()),
+    numMigrateMemCalls(0), numHostP2PTransfers(0),
     numObjectsReleased(0), contextEnabled(false),
     totalHostReadTime(0), totalHostWriteTime(0), totalBufferStartTime(0),
     totalBufferEndTime(0), firstKernelStartTime(0.0), lastKernelEndTime(0.0)
@@ -206,6 +208,15 @@ namespace xdp {
     }
   }
 
+  void VPStatisticsDatabase::logBufferCopy(const char* path, uint64_t size)
+  {
+    std::lock_guard<std::mutex> lock(dbLock);
+
+    auto& copies = bufferCopies[(path != nullptr) ? path : ""] ;
+    copies.first += 1 ;
+    copies.second += size ;
+  }
+
   void VPStatisticsDatabase::logFunctionCallStart(const std::string& name,
                                                   double timestamp)
   {
@@ -220,19 +231,11 @@ namespace xdp {
 
     auto threadId = std::this_thread::get_id();
     auto key      = std::make_pair(name, threadId);
-    auto value    = std::make_pair(timestamp, (double)0.0);
 
     // Since a single thread can call a function multiple times, we store
     // the starts in a vector.  If the thread makes a recursive call, we'll
-    // have multiple elements where the start value is set but the end value
-    // needs to be filled in.
-    if (callCount.find(key) == callCount.end()) {
-      std::vector<std::pair<double, double>> newVector;
-      newVector.push_back(value);
-      callCount[key] = newVector;
-    }
-    else
-      callCount[key].push_back(value);
+    // have multiple start times waiting for the end of the call.
+    openCalls[key].push_back(timestamp);
 
     // OpenCL specific information 
     if (name == "clEnqueueMigrateMemObjects")
@@ -247,18 +250,36 @@ namespace xdp {
     auto threadId = std::this_thread::get_id();
     auto key      = std::make_pair(name, threadId);
 
-    // Since some calls might be recursive, we must go backwards to find
-    // the first call that has a start time set but no end time.  Since we've
-    // incorporated the thread id as part of our key, we will match recursive
-    // calls correctly
-    for (auto iter = callCount[key].rbegin();
-         iter != callCount[key].rend();
-         ++iter) {
-      if ((*iter).second == 0) {
-        (*iter).second = timestamp;
-        break;
-      }
-    }
+    // Since some calls might be recursive, the call that ends is the
+    // most recent one started.  Since we've incorporated the thread id
+    // as part of our key, we will match recursive calls correctly
+    auto iter = openCalls.find(key);
+    if (iter == openCalls.end() || iter->second.empty())
+      return;
+
+    auto startTimestamp = iter->second.back();
+    iter->second.pop_back();
+    recordCall(key, startTimestamp, timestamp);
+  }
+
+  void VPStatisticsDatabase::logFunctionCall(const std::string& name,
+                                             std::thread::id threadId,
+                                             double startTimestamp,
+                                             double endTimestamp)
+  {
+    std::lock_guard<std::mutex> lock(dbLock);
+
+    auto key = std::make_pair(name, threadId);
+    recordCall(key, startTimestamp, endTimestamp);
+  }
+
+  void VPStatisticsDatabase::
+  recordCall(const std::pair<std::string, std::thread::id>& key,
+             double startTimestamp, double endTimestamp)
+  {
+    callStats[key].update(endTimestamp - startTimestamp);
+    if (keepCallSamples)
+      callSamples[key].emplace_back(startTimestamp, endTimestamp);
   }
 
   void VPStatisticsDatabase::logMemoryTransfer(uint64_t deviceId,
@@ -306,6 +327,8 @@ namespace xdp {
                                                 const char** buffers,
                                                 uint64_t numBuffers)
   {
+    std::lock_guard<std::mutex> lock(dbLock) ;
+
     if (kernelExecutionStats.find(kernelName) == kernelExecutionStats.end())
     {
       TimeStatistics blank ;
@@ -344,6 +367,10 @@ namespace xdp {
                                                      const std::string& globalWorkGroup,
                                                      uint64_t executionTime)
   {
+    // Compute unit executions can be logged by several trace decoding
+    // threads at once
+    std::lock_guard<std::mutex> lock(dbLock) ;
+
     // If global work size is not known, then we need to get it from the latest enqueue 
     // of the associated kernel.
     std::string globalWork = globalWorkGroup;
@@ -448,16 +475,9 @@ namespace xdp {
     //  the number of calls
     std::map<std::string, uint64_t> counts ;
 
-    for (const auto& c : callCount)
+    for (const auto& c : callStats)
     {
-      if (counts.find(c.first.first) == counts.end())
-      {
-        counts[c.first.first] = c.second.size() ;
-      }
-      else
-      {
-        counts[c.first.first] += c.second.size() ;
-      }
+      counts[c.first.first] += c.second.count ;
     }
 
     for (const auto& i : counts)
@@ -18,7 +18,10 @@
 #ifndef VP_STATISTICS_DATABASE_DOT_H
 #define VP_STATISTICS_DATABASE_DOT_H
 
+#include <array>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <list>
 #include <map>
 #include <mutex>
@@ -148,6 +151,145 @@ namespace xdp {
     }
   } ;
 
+  // Fixed size histogram of durations (in ns) using HDR style log-linear
+  //  buckets.  Values below 16 have a bucket each, and every power of
+  //  two above that is split into 16 equal buckets, so a recorded value
+  //  is known to within 1/16th of its magnitude.  Values are tracked up
+  //  to 2^48 ns (about 78 hours), larger values land in the last bucket.
+  struct LatencyHistogram
+  {
+    static constexpr uint32_t subBucketBits = 4 ;
+    static constexpr uint32_t subBucketCount = 1 << subBucketBits ;
+    static constexpr uint32_t maxMagnitude = 47 ;
+    static constexpr uint32_t numBuckets =
+      (maxMagnitude - subBucketBits + 2) * subBucketCount ;
+
+    std::array<uint64_t, numBuckets> counts {} ;
+    uint64_t total = 0 ;
+
+    // Position of the most significant set bit
+    static uint32_t magnitude(uint64_t value)
+    {
+      uint32_t m = 0 ;
+      for (uint32_t shift = 32 ; shift > 0 ; shift >>= 1) {
+        if (value >> shift) {
+          value >>= shift ;
+          m += shift ;
+        }
+      }
+      return m ;
+    }
+
+    static uint32_t bucketIndex(uint64_t value)
+    {
+      if (value < subBucketCount)
+        return static_cast<uint32_t>(value) ;
+      auto m = magnitude(value) ;
+      if (m > maxMagnitude)
+        return numBuckets - 1 ;
+      auto subBucket = (value >> (m - subBucketBits)) & (subBucketCount - 1) ;
+      return (m - subBucketBits + 1) * subBucketCount
+        + static_cast<uint32_t>(subBucket) ;
+    }
+
+    // Smallest value that is recorded in the bucket
+    static uint64_t bucketLowerBound(uint32_t index)
+    {
+      if (index < subBucketCount)
+        return index ;
+      uint32_t m = index / subBucketCount + subBucketBits - 1 ;
+      uint64_t subBucket = index % subBucketCount ;
+      return (subBucketCount + subBucket) << (m - subBucketBits) ;
+    }
+
+    void record(double value)
+    {
+      auto v = (value <= 0) ? 0 : static_cast<uint64_t>(value) ;
+      ++counts[bucketIndex(v)] ;
+      ++total ;
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+      for (uint32_t i = 0 ; i < numBuckets ; ++i)
+        counts[i] += other.counts[i] ;
+      total += other.total ;
+    }
+
+    // Approximate value below which the given fraction of the recorded
+    //  values fall, reported as the middle of the containing bucket
+    double percentile(double fraction) const
+    {
+      if (total == 0)
+        return 0 ;
+      auto rank = static_cast<uint64_t>(std::ceil(fraction * total)) ;
+      if (rank == 0)
+        rank = 1 ;
+      uint64_t seen = 0 ;
+      for (uint32_t i = 0 ; i < numBuckets ; ++i) {
+        seen += counts[i] ;
+        if (seen < rank)
+          continue ;
+        auto low = bucketLowerBound(i) ;
+        auto high = (i + 1 < numBuckets) ? bucketLowerBound(i + 1) : low ;
+        return (static_cast<double>(low) + static_cast<double>(high)) / 2 ;
+      }
+      return static_cast<double>(bucketLowerBound(numBuckets - 1)) ;
+    }
+  } ;
+
+  // Statistics on the durations of calls to an API, kept in fixed
+  //  memory no matter how many calls are made
+  struct CallStatistics
+  {
+    uint64_t count ;
+    double totalTime ;
+    double minTime ;
+    double maxTime ;
+    double averageTime ;
+    double sumSquares ; // Sum of squared differences from the average
+    LatencyHistogram histogram ;
+
+    CallStatistics() : count(0), totalTime(0),
+      minTime((std::numeric_limits<double>::max)()), maxTime(0),
+      averageTime(0), sumSquares(0) { }
+
+    void update(double executionTime)
+    {
+      // Welford's method keeps the variance numerically stable
+      ++count ;
+      totalTime += executionTime ;
+      auto delta = executionTime - averageTime ;
+      averageTime += delta / count ;
+      sumSquares += delta * (executionTime - averageTime) ;
+      if (minTime > executionTime) minTime = executionTime ;
+      if (maxTime < executionTime) maxTime = executionTime ;
+      histogram.record(executionTime) ;
+    }
+
+    // Combine the statistics of another thread's calls into these
+    void merge(const CallStatistics& other)
+    {
+      if (other.count == 0)
+        return ;
+      auto newCount = count + other.count ;
+      auto delta = other.averageTime - averageTime ;
+      sumSquares += other.sumSquares
+        + delta * delta * (static_cast<double>(count) * other.count / newCount) ;
+      averageTime += delta * other.count / newCount ;
+      count = newCount ;
+      totalTime += other.totalTime ;
+      if (minTime > other.minTime) minTime = other.minTime ;
+      if (maxTime < other.maxTime) maxTime = other.maxTime ;
+      histogram.merge(other.histogram) ;
+    }
+
+    double getVariance() const
+    {
+      return (count > 1) ? sumSquares / (count - 1) : 0 ;
+    }
+  } ;
+
   struct MemoryChannelStatistics
   {
     uint64_t transactionCount ;
@@ -176,8 +318,18 @@ namespace xdp {
 
   private:
     // Statistics on API calls (OpenCL and HAL) have to be thread specific
+    std::map<std::pair<std::string, std::thread::id>, CallStatistics> callStats ;
+
+    // Start times of the calls each thread has in progress.  Recursive
+    //  calls push additional start times, the innermost call is last.
     std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount ;
+             std::vector<double>> openCalls ;
+
+    // The start and end of every API call.  Grows with every call, so
+    //  only kept when explicitly requested in xrt.ini.
+    bool keepCallSamples ;
+    std::map<std::pair<std::string, std::thread::id>,
+             std::vector<std::pair<double, double>>> callSamples ;
 
     // **** User Level Event Statistics ****
     std::map<std::string, uint64_t> eventCounts ;
@@ -186,6 +338,11 @@ namespace xdp {
     std::map<std::pair<const char*, const char*>, uint64_t> maxRangeDurations ;
     std::map<std::pair<const char*, const char*>, uint64_t> totalRangeDurations;
 
+    // **** Native XRT Statistics ****
+    // Number of buffer to buffer copies and total bytes copied per
+    //  copy path (m2m, kdma, host, ...)
+    std::map<std::string, std::pair<uint64_t, uint64_t>> bufferCopies ;
+
     // **** HAL Statistics ****
     // For HAL, each device will have four different read/write
     //  channels that need to be kept track of.
@@ -248,14 +405,22 @@ namespace xdp {
     void addTopHostWrite(BufferTransferStats& transfer) ;
     void addTopKernelExecution(KernelExecutionStats& exec) ;
 
+    // Helper function for API calls, must be called with dbLock held
+    void recordCall(const std::pair<std::string, std::thread::id>& key,
+                    double startTimestamp, double endTimestamp) ;
+
   public:
     XDP_CORE_EXPORT VPStatisticsDatabase(VPDatabase* d) ;
     XDP_CORE_EXPORT ~VPStatisticsDatabase() ;
 
     // Getters and setters
     inline const std::map<std::pair<std::string, std::thread::id>,
-                    std::vector<std::pair<double, double>>>& getCallCount() 
-      { return callCount ; }
+                          CallStatistics>& getCallStats()
+      { return callStats ; }
+    inline bool callSamplesPresent() { return keepCallSamples ; }
+    inline const std::map<std::pair<std::string, std::thread::id>,
+                    std::vector<std::pair<double, double>>>& getCallSamples()
+      { return callSamples ; }
     inline const std::map<uint64_t, DeviceMemoryStatistics>& getMemoryStats() 
       { return memoryStats ; }
     inline const std::map<std::string, TimeStatistics>& getKernelExecutionStats() 
@@ -331,11 +496,24 @@ namespace xdp {
     getTotalRangeDurations()
       { return totalRangeDurations; }
 
+    // Native XRT buffer copy functions
+    inline bool bufferCopyInformationPresent() { return bufferCopies.size() != 0 ; }
+    XDP_CORE_EXPORT void logBufferCopy(const char* path, uint64_t size) ;
+    inline std::map<std::string, std::pair<uint64_t, uint64_t>>&
+    getBufferCopies()
+      { return bufferCopies; }
+
     // Logging Functions
     XDP_CORE_EXPORT void logFunctionCallStart(const std::string& name, 
                                          double timestamp) ;
     XDP_CORE_EXPORT void logFunctionCallEnd(const std::string& name, 
                                        double timestamp) ;
+    // Log a complete call made by the specified thread, for plugins
+    // that record calls on one thread and log them from another
+    XDP_CORE_EXPORT void logFunctionCall(const std::string& name,
+                                         std::thread::id threadId,
+                                         double startTimestamp,
+                                         double endTimestamp) ;
 
     XDP_CORE_EXPORT void logMemoryTransfer(uint64_t deviceId, 
                                       DeviceMemoryStatistics::ChannelType channelType,
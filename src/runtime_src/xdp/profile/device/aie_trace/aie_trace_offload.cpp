@@ -17,8 +17,10 @@
 
 #define XDP_PLUGIN_SOURCE
 
+#include <algorithm>
 #include <iostream>
 
+#include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include "core/include/xrt/xrt_kernel.h"
 #include "xdp/profile/database/database.h"
@@ -58,6 +60,7 @@ AIETraceOffload::AIETraceOffload
   , numStream(numStrm)
   , traceContinuous(false)
   , offloadIntervalUs(0)
+  , adaptiveInterval(xrt_core::config::get_aie_trace_settings_adaptive_offload_interval())
   , bufferInitialized(false)
   , offloadStatus(AIEOffloadThreadStatus::IDLE)
   , mEnCircularBuf(false)
@@ -424,6 +427,7 @@ uint64_t AIETraceOffload::syncAndLog(uint64_t index)
 
   // Log nBytes of trace
   traceLogger->addAIETraceData(index, hostBuf, nBytes, mEnCircularBuf);
+  bd.polledSz += nBytes;
   return nBytes;
 }
 
@@ -499,9 +503,22 @@ void AIETraceOffload::continuousOffload()
     return;
   }
 
+  uint64_t intervalUs = offloadIntervalUs;
+  auto lastPoll = std::chrono::steady_clock::now();
+
   while (keepOffloading()) {
+    for (auto& bd : buffers)
+      bd.polledSz = 0;
+
     mReadTrace(false);
-    std::this_thread::sleep_for(std::chrono::microseconds(offloadIntervalUs));
+
+    if (adaptiveInterval) {
+      auto now = std::chrono::steady_clock::now();
+      auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - lastPoll).count();
+      lastPoll = now;
+      intervalUs = nextOffloadIntervalUs(intervalUs, static_cast<uint64_t>(elapsedUs));
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(intervalUs));
   }
 
   // Note: This will call flush and reset on datamover
@@ -510,6 +527,45 @@ void AIETraceOffload::continuousOffload()
   offloadFinished();
 }
 
+// Choose the time until the next poll from the rate the busiest stream
+// filled its buffer since the last poll.  Aim to read a quarter of the
+// buffer per poll, which leaves room for bursts before the datamover
+// wraps around a circular buffer.  Back off gradually while there is
+// little trace so offload does not spin, but never poll less often than
+// buffer_offload_interval_us.  A circular buffer that is not read in
+// time is overrun and its trace is dropped, so with reuse_buffer the
+// interval also stays within the limit recommended for that mode.
+uint64_t AIETraceOffload::nextOffloadIntervalUs(uint64_t currentUs, uint64_t elapsedUs)
+{
+  uint64_t maxPolledSz = 0;
+  for (auto& bd : buffers)
+    maxPolledSz = std::max(maxPolledSz, bd.polledSz);
+
+  uint64_t maxUs = offloadIntervalUs;
+  if (mEnCircularBuf)
+    maxUs = std::min<uint64_t>(maxUs, AIE_TRACE_REUSE_MAX_OFFLOAD_INT_US);
+  maxUs = std::max<uint64_t>(maxUs, AIE_TRACE_MIN_OFFLOAD_INT_US);
+  uint64_t targetSz = bufAllocSz / 4;
+
+  uint64_t nextUs = maxUs;
+  if (maxPolledSz > 0 && elapsedUs > 0) {
+    // Time to produce targetSz bytes at the observed rate
+    double rate = static_cast<double>(maxPolledSz) / elapsedUs;
+    nextUs = static_cast<uint64_t>(targetSz / rate);
+  }
+
+  // React to rising rates at once, but only double the interval per poll
+  nextUs = std::min(nextUs, 2 * std::max<uint64_t>(currentUs, AIE_TRACE_MIN_OFFLOAD_INT_US));
+  nextUs = std::clamp<uint64_t>(nextUs, AIE_TRACE_MIN_OFFLOAD_INT_US, maxUs);
+
+  if (nextUs != currentUs) {
+    debug_stream
+      << "AIE trace offload interval : " << nextUs << "us"
+      << " (" << maxPolledSz << " bytes in " << elapsedUs << "us)" << std::endl;
+  }
+  return nextUs;
+}
+
 bool AIETraceOffload::keepOffloading()
 {
   std::lock_guard<std::mutex> lock(statusLock);
@@ -52,6 +52,7 @@ struct AIETraceBufferInfo
 //  uint64_t allocSz;	// currently all the buffers are equal size
   uint64_t usedSz;
   uint64_t offset;
+  uint64_t polledSz;	// bytes offloaded in the current poll
   uint32_t rollover_count;
   bool     isFull;
   bool     offloadDone;
@@ -60,6 +61,7 @@ struct AIETraceBufferInfo
     : bufId(0),
       usedSz(0),
       offset(0),
+      polledSz(0),
       rollover_count(0),
       isFull(false),
       offloadDone(false)
@@ -145,6 +147,7 @@ private:
     // Continuous Trace Offload (For PLIO)
     bool traceContinuous;
     uint64_t offloadIntervalUs;
+    bool adaptiveInterval;
     bool bufferInitialized;
     std::mutex statusLock;
     AIEOffloadThreadStatus offloadStatus;
@@ -159,6 +162,7 @@ private:
     void readTraceGMIO(bool final);
     bool setupPSKernel();
     void continuousOffload();
+    uint64_t nextOffloadIntervalUs(uint64_t currentUs, uint64_t elapsedUs);
     bool keepOffloading();
     void offloadFinished();
     void checkCircularBufferSupport();
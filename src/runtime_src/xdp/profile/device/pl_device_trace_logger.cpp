@@ -22,9 +22,15 @@
 #include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/database/static_info/xclbin_info.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include "experimental/xrt_profile.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
 #ifdef _WIN32
 #pragma warning (disable : 4244)
 /* Disable warnings for conversion from uint32_t to uint16_t */
@@ -59,6 +65,104 @@ namespace xdp {
     //  any configured for just trace.
     aimLastTrans.resize((db->getStaticInfo()).getNumUserAIM(deviceId, xclbin));
     asmLastTrans.resize((db->getStaticInfo()).getNumUserASM(deviceId, xclbin));
+
+    initializeLanes();
+  }
+
+  void PLDeviceTraceLogger::initializeLanes()
+  {
+    // Cache the monitors for every slot a trace ID can refer to
+    amMonitors.resize((util::max_trace_id_am - util::min_trace_id_am) / 16 + 1);
+    for (uint64_t slot = 0; slot < amMonitors.size(); ++slot)
+      amMonitors[slot] = db->getStaticInfo().getAMonitor(deviceId, xclbin, slot);
+
+    aimMonitors.resize(util::max_trace_id_aim / 2 + 1);
+    aimMemStrIds.resize(aimMonitors.size(), 0);
+    for (uint64_t slot = 0; slot < aimMonitors.size(); ++slot) {
+      Monitor* mon = db->getStaticInfo().getAIMonitor(deviceId, xclbin, slot);
+      aimMonitors[slot] = mon;
+      if (mon && -1 != mon->memIndex) {
+        Memory* mem = db->getStaticInfo().getMemory(deviceId, mon->memIndex);
+        if (nullptr != mem)
+          aimMemStrIds[slot] = db->getDynamicInfo().addString(mem->spTag);
+      }
+    }
+
+    asmMonitors.resize(util::max_trace_id_asm - util::min_trace_id_asm);
+    for (uint64_t slot = 0; slot < asmMonitors.size(); ++slot)
+      asmMonitors[slot] = db->getStaticInfo().getASMonitor(deviceId, xclbin, slot);
+
+    // Monitors attached to the same compute unit share a lane.  Floating
+    //  monitors each get their own.  Packets from unknown monitors are
+    //  ignored by the decoder, so they are not assigned a lane.
+    std::map<int32_t, uint32_t> cuLanes;
+    uint32_t numLanes = 0;
+    auto laneOf = [&cuLanes, &numLanes](const Monitor* mon) {
+      if (mon->cuIndex == -1)
+        return numLanes++;
+      auto iter = cuLanes.find(mon->cuIndex);
+      if (iter != cuLanes.end())
+        return iter->second;
+      cuLanes[mon->cuIndex] = numLanes;
+      return numLanes++;
+    };
+
+    traceIdLanes.assign(numTraceIds, noLane);
+    for (uint64_t slot = 0; slot < amMonitors.size(); ++slot) {
+      if (!amMonitors[slot])
+        continue;
+      auto lane = laneOf(amMonitors[slot]);
+      for (uint64_t i = 0; i < 16; ++i) {
+        auto traceId = slot * 16 + util::min_trace_id_am + i;
+        if (traceId <= util::max_trace_id_am)
+          traceIdLanes[traceId] = lane;
+      }
+    }
+    for (uint64_t slot = 0; slot < aimMonitors.size(); ++slot) {
+      if (!aimMonitors[slot])
+        continue;
+      auto lane = laneOf(aimMonitors[slot]);
+      traceIdLanes[slot * 2] = lane;
+      traceIdLanes[slot * 2 + 1] = lane;
+    }
+    for (uint64_t slot = 0; slot < asmMonitors.size(); ++slot) {
+      if (asmMonitors[slot])
+        traceIdLanes[slot + util::min_trace_id_asm] = laneOf(asmMonitors[slot]);
+    }
+    lanes.resize(numLanes);
+
+    numDecodeThreads = xrt_core::config::get_device_trace_decode_threads();
+    if (numDecodeThreads == 0)
+      numDecodeThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  PLDeviceTraceLogger::~PLDeviceTraceLogger()
+  {
+    stopDecodeWorkers();
+  }
+
+  void PLDeviceTraceLogger::logKernelStart(double hostTimestamp)
+  {
+    std::lock_guard<std::mutex> lock(kernelTimesLock);
+    if (firstKernelStart == 0.0 || hostTimestamp < firstKernelStart)
+      firstKernelStart = hostTimestamp;
+  }
+
+  void PLDeviceTraceLogger::logKernelEnd(double hostTimestamp)
+  {
+    std::lock_guard<std::mutex> lock(kernelTimesLock);
+    if (hostTimestamp > lastKernelEnd)
+      lastKernelEnd = hostTimestamp;
+  }
+
+  // Called once the lanes are done to publish the kernel times
+  void PLDeviceTraceLogger::updateKernelTimes()
+  {
+    std::lock_guard<std::mutex> lock(kernelTimesLock);
+    if (firstKernelStart != 0.0)
+      (db->getStats()).setFirstKernelStartTime(firstKernelStart);
+    if (lastKernelEnd != 0.0)
+      (db->getStats()).setLastKernelEndTime(lastKernelEnd);
   }
 
   void PLDeviceTraceLogger::addCUEndEvent(double hostTimestamp,
@@ -79,7 +183,7 @@ namespace xdp {
                                  hostTimestamp, KERNEL, deviceId, s, cuId);
     event->setDeviceTimestamp(deviceTimestamp);
     db->getDynamicInfo().addEvent(event);
-    (db->getStats()).setLastKernelEndTime(hostTimestamp);
+    logKernelEnd(hostTimestamp);
 
     // Log a CU execution in our statistics database
     // NOTE: At this stage, we don't know the global work size, so let's
@@ -130,8 +234,7 @@ namespace xdp {
       if(1 == cuStarts[slot].size()) {
         traceIDs[slot] = 0; // When current CU starts, reset stall status
       }
-      if (db->getStats().getFirstKernelStartTime() == 0.0)
-        (db->getStats()).setFirstKernelStartTime(hostTimestamp);
+      logKernelStart(hostTimestamp);
     }
   }
 
@@ -181,7 +284,7 @@ namespace xdp {
     uint32_t slot = (traceID - util::min_trace_id_am) / 16;
     uint64_t monTraceID = slot * 16 + util::min_trace_id_am;
 
-    Monitor* mon = db->getStaticInfo().getAMonitor(deviceId, xclbin, slot);
+    Monitor* mon = getCachedMonitor(amMonitors, slot);
     if (!mon) {
       // In hardware emulation, there might be monitors inserted
       //  that don't show up in the debug ip layout.  These are added
@@ -226,7 +329,7 @@ namespace xdp {
     uint64_t traceID = getTraceId(trace);
 
     uint32_t slot = traceID / 2;
-    Monitor* mon = db->getStaticInfo().getAIMonitor(deviceId, xclbin, slot);
+    Monitor* mon = getCachedMonitor(aimMonitors, slot);
     if (!mon) {
       // In hardware emulation, there might be monitors inserted that
       //  don't show up in the debug ip layout.  These are added for
@@ -234,13 +337,7 @@ namespace xdp {
       //  we see from them
       return ;
     }
-    uint64_t memStrId = 0;
-    if(-1 != mon->memIndex) {
-      Memory* mem = db->getStaticInfo().getMemory(deviceId, mon->memIndex);
-      if(nullptr != mem) {
-        memStrId = db->getDynamicInfo().addString(mem->spTag);
-      }
-    }
+    uint64_t memStrId = aimMemStrIds[slot];
 
     int32_t cuId = mon->cuIndex;
     VTFEventType ty = (traceID & 0x1) ? KERNEL_WRITE : KERNEL_READ;
@@ -255,7 +352,7 @@ namespace xdp {
     auto deviceTimestamp = getDeviceTimestamp(trace);
     auto slot = traceId - util::min_trace_id_asm;
 
-    Monitor* mon  = db->getStaticInfo().getASMonitor(deviceId, xclbin, slot);
+    Monitor* mon  = getCachedMonitor(asmMonitors, slot);
     if (!mon) {
       // In hardware emulation, there might be monitors inserted
       //  that don't show up in the debug ip layout.  These are added
@@ -747,7 +844,7 @@ namespace xdp {
     //  is garbage from the previous run
     // Note: This needs to be done only in beginning chunk of data
     static bool found = false;
-    if (!found) {
+    if (!found && numPackets >= 8) {
       for (uint64_t i = 0; i < numPackets - 8; ++i) {
         for (uint64_t j = i; j < i + 8; ++j) {
           uint64_t packet = (static_cast<uint64_t*>(data))[j];
@@ -793,6 +890,10 @@ namespace xdp {
         clockTrainingHostTimestamp |= ((packet >> 45) & 0xFFFF) << (16 * modulus);
         ++modulus;
         if (modulus == 4) {
+          // Packets collected so far were converted with the previous
+          //  training, so decode them before it changes
+          decodeLanes();
+
           // It requires four complete clock training packets before
           //  we can perform the clock training algorithm
           trainDeviceHostTimestamps(clockTrainingDeviceTimestamp,
@@ -814,20 +915,130 @@ namespace xdp {
       }
 
       double hostTimestamp = convertDeviceToHostTimestamp(deviceTimestamp);
-      if (AMPacket) {
-        addAMEvent(packet, hostTimestamp);
-      }
-      if (AIMPacket) {
-        addAIMEvent(packet, hostTimestamp);
-      }
-      if (ASMPacket) {
-        addASMEvent(packet, hostTimestamp);
+      if (traceId < traceIdLanes.size() && traceIdLanes[traceId] != noLane) {
+        lanes[traceIdLanes[traceId]].push_back({packet, hostTimestamp});
+        ++numLanePackets;
       }
 
       // keep track of latest timestamp that comes through trace
       mLatestHostTimestampMs = hostTimestamp;
     }
 
+    decodeLanes();
+    updateKernelTimes();
+  }
+
+  void PLDeviceTraceLogger::decodePacket(uint64_t packet, double hostTimestamp)
+  {
+    auto traceId = getTraceId(packet);
+
+    bool AMPacket  = (traceId >= util::min_trace_id_am &&
+                      traceId <= util::max_trace_id_am);
+    bool AIMPacket = (traceId <= util::max_trace_id_aim); // min trace id aim == 0
+    bool ASMPacket = (traceId >= util::min_trace_id_asm &&
+                      traceId <  util::max_trace_id_asm);
+    if (AMPacket) {
+      addAMEvent(packet, hostTimestamp);
+    }
+    if (AIMPacket) {
+      addAIMEvent(packet, hostTimestamp);
+    }
+    if (ASMPacket) {
+      addASMEvent(packet, hostTimestamp);
+    }
+  }
+
+  void PLDeviceTraceLogger::decodeLane(uint32_t lane)
+  {
+    for (const auto& p : lanes[lane])
+      decodePacket(p.packet, p.hostTimestamp);
+    lanes[lane].clear();
+  }
+
+  void PLDeviceTraceLogger::decodeBusyLanes()
+  {
+    for (auto i = nextBusyLane++; i < busyLanes.size(); i = nextBusyLane++)
+      decodeLane(busyLanes[i]);
+  }
+
+  void PLDeviceTraceLogger::decodeWorker()
+  {
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(decodeLock);
+    while (true) {
+      decodeStart.wait(lock, [this, generation] {
+        return decodeStop || decodeGeneration != generation;
+      });
+      if (decodeStop)
+        return;
+
+      generation = decodeGeneration;
+      lock.unlock();
+      decodeBusyLanes();
+      lock.lock();
+      if (--decodeActive == 0)
+        decodeDone.notify_one();
+    }
+  }
+
+  void PLDeviceTraceLogger::stopDecodeWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(decodeLock);
+      decodeStop = true;
+    }
+    decodeStart.notify_all();
+    for (auto& t : decodeWorkers)
+      t.join();
+    decodeWorkers.clear();
+  }
+
+  void PLDeviceTraceLogger::decodeLanes()
+  {
+    if (numLanePackets == 0)
+      return;
+
+    busyLanes.clear();
+    for (uint32_t lane = 0; lane < lanes.size(); ++lane) {
+      if (!lanes[lane].empty())
+        busyLanes.push_back(lane);
+    }
+
+    if (numDecodeThreads <= 1 || busyLanes.size() <= 1 ||
+        numLanePackets < parallelDecodeThreshold) {
+      for (auto lane : busyLanes)
+        decodeLane(lane);
+      numLanePackets = 0;
+      return;
+    }
+
+    // Start with the busiest lanes so one long lane does not end up
+    //  running alone at the end
+    std::sort(busyLanes.begin(), busyLanes.end(), [this](uint32_t a, uint32_t b) {
+      return lanes[a].size() > lanes[b].size();
+    });
+
+    if (decodeWorkers.empty()) {
+      for (unsigned int i = 1; i < numDecodeThreads; ++i)
+        decodeWorkers.emplace_back(&PLDeviceTraceLogger::decodeWorker, this);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(decodeLock);
+      nextBusyLane = 0;
+      decodeActive = static_cast<unsigned int>(decodeWorkers.size());
+      ++decodeGeneration;
+    }
+    decodeStart.notify_all();
+
+    decodeBusyLanes();
+
+    {
+      std::unique_lock<std::mutex> lock(decodeLock);
+      decodeDone.wait(lock, [this] { return decodeActive == 0; });
+    }
+
+    numLanePackets = 0;
   }
 
   void PLDeviceTraceLogger::endProcessTraceData()
@@ -835,6 +1046,7 @@ namespace xdp {
     addApproximateCUEndEvents();
     addApproximateDataTransferEndEvents();
     addApproximateStreamEndEvents();
+    updateKernelTimes();
   }
 
   void PLDeviceTraceLogger::addEventMarkers(bool isFIFOFull, bool isTS2MMFull)
@@ -18,6 +18,11 @@
 #ifndef _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 #define _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "xdp/config.h"
@@ -44,6 +49,69 @@ namespace xdp {
     std::vector<uint64_t> aimLastTrans;
     std::vector<uint64_t> asmLastTrans;
 
+    // Monitors and memory names looked up for every packet, cached by
+    //  slot so decoding does not search the static database
+    std::vector<Monitor*> amMonitors;
+    std::vector<Monitor*> aimMonitors;
+    std::vector<Monitor*> asmMonitors;
+    std::vector<uint64_t> aimMemStrIds;
+
+    // All state used to decode a packet belongs to the monitor that
+    //  produced it or to the compute unit the monitor is attached to.
+    //  Packets are split into lanes, one per compute unit (with all of
+    //  its monitors) and one per floating monitor, and lanes are decoded
+    //  in parallel.  Within a lane, packets keep their original order.
+    //  The database keeps device events sorted by timestamp, which
+    //  merges the lanes.
+    struct LanePacket
+    {
+      uint64_t packet;
+      double hostTimestamp;
+    };
+    static constexpr uint64_t numTraceIds = 0x1000;
+    static constexpr uint32_t noLane = (std::numeric_limits<uint32_t>::max)();
+    std::vector<uint32_t> traceIdLanes; // Trace ID to lane index
+    std::vector<std::vector<LanePacket>> lanes;
+    uint64_t numLanePackets = 0;
+    unsigned int numDecodeThreads = 1;
+
+    // Below this many packets, decode on the calling thread
+    static constexpr uint64_t parallelDecodeThreshold = 8192;
+
+    // Lanes are decoded in parallel by a pool of worker threads that
+    //  is started the first time the threshold is exceeded and lives
+    //  as long as the logger.  The calling thread decodes lanes too.
+    std::vector<std::thread> decodeWorkers;
+    std::mutex decodeLock;              // Protects the fields below
+    std::condition_variable decodeStart;
+    std::condition_variable decodeDone;
+    uint64_t decodeGeneration = 0;      // Incremented for each parallel decode
+    unsigned int decodeActive = 0;      // Workers busy with current generation
+    bool decodeStop = false;
+    std::vector<uint32_t> busyLanes;    // Lanes of current generation
+    std::atomic<size_t> nextBusyLane {0};
+
+    void decodeLane(uint32_t lane);
+    void decodeBusyLanes();
+    void decodeWorker();
+    void stopDecodeWorkers();
+
+    // First kernel start and last kernel end seen by any lane
+    std::mutex kernelTimesLock;
+    double firstKernelStart = 0;
+    double lastKernelEnd = 0;
+    void logKernelStart(double hostTimestamp);
+    void logKernelEnd(double hostTimestamp);
+    void updateKernelTimes();
+
+    inline Monitor* getCachedMonitor(const std::vector<Monitor*>& monitors,
+                                     uint64_t slot)
+      { return (slot < monitors.size()) ? monitors[slot] : nullptr; }
+
+    void initializeLanes();
+    void decodePacket(uint64_t packet, double hostTimestamp);
+    void decodeLanes();
+
     // Parsing functions for getting different parts of a device event packet
     inline uint64_t getDeviceTimestamp(uint64_t trace)
       { return (trace & 0x1FFFFFFFFFFF) - firstTimestamp; }
@@ -111,7 +179,7 @@ namespace xdp {
   public:
 
     XDP_CORE_EXPORT PLDeviceTraceLogger(uint64_t devId);
-    XDP_CORE_EXPORT ~PLDeviceTraceLogger() = default;
+    XDP_CORE_EXPORT ~PLDeviceTraceLogger();
 
     XDP_CORE_EXPORT void processTraceData(void* data, uint64_t numBytes);
     XDP_CORE_EXPORT void endProcessTraceData();
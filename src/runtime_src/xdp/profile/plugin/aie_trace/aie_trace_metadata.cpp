@@ -140,7 +140,8 @@ namespace xdp {
       "graph_based_interface_tile_metrics", "tile_based_interface_tile_metrics",
       "start_type", "start_time", "start_iteration", "end_type",
       "periodic_offload", "reuse_buffer", "buffer_size", 
-      "buffer_offload_interval_us", "file_dump_interval_s",
+      "buffer_offload_interval_us", "adaptive_offload_interval",
+      "file_dump_interval_s",
       "enable_system_timeline", "poll_timers_interval_us"
     };
     const std::map<std::string, std::string> deprecatedSettings {
@@ -88,7 +88,8 @@ namespace xdp {
 
   PLDeviceOffloadPlugin::PLDeviceOffloadPlugin() :
     XDPPlugin(),
-    device_trace(false), continuous_trace(false), trace_buffer_offload_interval_ms(10)
+    device_trace(false), continuous_trace(false), binary_trace(false),
+    trace_buffer_offload_interval_ms(10)
   {
     db->registerPlugin(this) ;
 
@@ -100,6 +101,9 @@ namespace xdp {
       device_trace = true;
     }
 
+    binary_trace =
+      (xrt_core::config::get_device_trace_file_format() == "binary");
+
     // Get the profiling continuous offload options from xrt.ini
     //  Device offload continuous offload and dumping is only supported
     //  for hardware, not emulation
@@ -133,20 +137,21 @@ namespace xdp {
     std::string xrtVersion   = xdp::getXRTVersion() ;
     std::string toolVersion  = xdp::getToolVersion() ;
 
-    std::string filename = 
-      "device_trace_" + std::to_string(deviceId) + ".csv" ;
+    std::string filename = "device_trace_" + std::to_string(deviceId) +
+      (binary_trace ? ".bin" : ".csv") ;
 
     VPWriter* writer = new DeviceTraceWriter(filename.c_str(),
                                              deviceId,
                                              version,
                                              creationTime,
                                              xrtVersion,
-                                             toolVersion);
+                                             toolVersion,
+                                             binary_trace);
     writers.push_back(writer);
-    (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "VP_TRACE") ;
+    (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), traceFileType()) ;
 
     if (continuous_trace)
-      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), "VP_TRACE");
+      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), traceFileType());
   }
 
   void PLDeviceOffloadPlugin::configureDataflow(uint64_t deviceId,
@@ -448,7 +453,7 @@ namespace xdp {
       break ;
     case VPDatabase::DUMP_TRACE:
       {
-        XDPPlugin::trySafeWrite("VP_TRACE", true);
+        XDPPlugin::trySafeWrite(traceFileType(), true);
       }
       break ;
     default:
@@ -48,9 +48,14 @@ namespace xdp {
     //  from xrt.ini.
     bool device_trace;
     bool continuous_trace ;
+    bool binary_trace ;
     unsigned int trace_buffer_offload_interval_ms ;
     bool m_enable_circular_buffer = false;
 
+    // The type recorded for device trace files in the run summary
+    const char* traceFileType() const
+    { return binary_trace ? "VP_TRACE_BINARY" : "VP_TRACE" ; }
+
   protected:
     // Each device offload plugin is responsible for offloading
     //  information from all devices.  This holds all the objects
@@ -45,7 +45,7 @@ namespace xdp {
     VTFEvent* event =
       new HALAPICall(0,
                      timestamp,
-                     (db->getDynamicInfo()).addString(functionName));
+                     (db->getDynamicInfo()).addStaticString(functionName));
     (db->getDynamicInfo()).addEvent(event) ;
     (db->getDynamicInfo()).markStart(id, event->getEventId()) ;
   }
@@ -62,7 +62,7 @@ namespace xdp {
     VTFEvent* event =
       new HALAPICall((db->getDynamicInfo()).matchingStart(id),
 		     timestamp,
-		     (db->getDynamicInfo()).addString(functionName));
+		     (db->getDynamicInfo()).addStaticString(functionName));
     (db->getDynamicInfo()).addEvent(event) ;
   }
 
@@ -15,15 +15,13 @@
  * under the License.
  */
 
-#include <map>
-#include <mutex>
+#include <memory>
 
 #define XDP_PLUGIN_SOURCE
 
 #include "core/common/time.h"
-#include "xdp/profile/database/dynamic_info/types.h"
-#include "xdp/profile/database/events/native_events.h"
 #include "xdp/profile/plugin/native/native_cb.h"
+#include "xdp/profile/plugin/native/native_event_buffer.h"
 #include "xdp/profile/plugin/native/native_plugin.h"
 
 namespace xdp {
@@ -33,14 +31,87 @@ namespace xdp {
   // functions below.
   static NativeProfilingPlugin nativePluginInstance;
 
-  // For logging statistics: Function ID to start timestamp
-  static std::mutex timestampLock;
-  static std::map<uint64_t, uint64_t> nativeTimestamps;
+  // Each thread records its API calls in its own event buffer, which
+  // is drained into the database by the plugin.  The buffer pointer is
+  // trivially destructible so it remains accessible while the thread
+  // is exiting, after the buffer has been retired.
+  static thread_local NativeEventBuffer* threadBuffer = nullptr;
+  static thread_local bool threadExited = false;
+
+  struct ThreadBufferOwner
+  {
+    std::shared_ptr<NativeEventBuffer> buffer;
+
+    ~ThreadBufferOwner()
+    {
+      threadBuffer = nullptr;
+      threadExited = true;
+      if (buffer)
+        buffer->retire();
+    }
+  };
+
+  static NativeEventBuffer* getThreadBuffer()
+  {
+    if (threadBuffer || threadExited)
+      return threadBuffer;
+
+    static thread_local ThreadBufferOwner owner;
+    owner.buffer = std::make_shared<NativeEventBuffer>();
+    nativePluginInstance.registerBuffer(owner.buffer);
+    threadBuffer = owner.buffer.get();
+    return threadBuffer;
+  }
+
+  static void startCall(const char* functionName, uint64_t functionID,
+                        NativeEventType type)
+  {
+    // API calls made while the thread is exiting are not traced
+    auto buffer = getThreadBuffer();
+    if (!buffer)
+      return;
+
+    // Don't include the profiling overhead in the time that we show.
+    // That means there will be "empty gaps" in the timeline trace when
+    // the profiling overhead exists.  The timestamp is taken as late
+    // as possible.
+    buffer->startCall(functionID, functionName, xrt_core::time_ns(), type);
+  }
+
+  static void endCall(uint64_t functionID, uint64_t timestamp, uint64_t size)
+  {
+    auto buffer = getThreadBuffer();
+    if (!buffer)
+      return;
+
+    NativeEventRecord record;
+    if (!buffer->endCall(functionID, timestamp, size, record))
+      return;
+
+    // If the drain thread is falling behind, process in this thread
+    if (!buffer->push(record))
+      nativePluginInstance.processRecord(record, buffer->getThreadId());
+  }
+
+  static void completeCall(const char* functionName, uint64_t start,
+                           uint64_t end)
+  {
+    auto buffer = getThreadBuffer();
+    if (!buffer)
+      return;
+
+    NativeEventRecord record { functionName, start, end, 0,
+                               NativeEventType::API };
+    if (!buffer->push(record))
+      nativePluginInstance.processRecord(record, buffer->getThreadId());
+  }
 
 } // end namespace xdp
 
 // The functionID is the unique identifier from the XRT side that we
-// can use to match start events with stop events.
+// can use to match start events with stop events.  No database access
+// happens in these callbacks, the events and statistics are recorded
+// when the per thread buffers are drained.
 extern "C"
 void native_function_start(const char* functionName,
                            unsigned long long int functionID)
@@ -48,24 +119,8 @@ void native_function_start(const char* functionName,
   if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
     return;
 
-  // Don't include the profiling overhead in the time that we show.
-  // That means there will be "empty gaps" in the timeline trace when
-  // the profiling overhead exists.  That means we create the event
-  // and add it to the database first, and set the timestamp as close as
-  // possible to the true start of the observed function.
-  xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase();
-
-  xdp::VTFEvent* event =
-    new xdp::NativeAPICall(0,
-                           0,
-                           db->getDynamicInfo().addString(functionName));
-  db->getDynamicInfo().addUnsortedEvent(event);
-  db->getDynamicInfo().markStart(static_cast<uint64_t>(functionID),
-                                 event->getEventId());
-
-  db->getStats().logFunctionCallStart(functionName,
-                                      static_cast<double>(xrt_core::time_ns()));
-  event->setTimestamp(static_cast<double>(xrt_core::time_ns()));
+  xdp::startCall(functionName, static_cast<uint64_t>(functionID),
+                 xdp::NativeEventType::API);
 }
 
 // In order to not show profiling overhead in the timeline, we have
@@ -74,29 +129,36 @@ void native_function_start(const char* functionName,
 // consideration.  The timestamp is as close to the true end of the
 // observed function as possible.
 extern "C"
-void native_function_end(const char* functionName,
+void native_function_end(const char* /*functionName*/,
                          unsigned long long int functionID,
                          unsigned long long int timestamp)
 {
   if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
     return;
 
-  xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase();
-  db->getStats().logFunctionCallEnd(functionName,
-                                    static_cast<double>(timestamp));
+  xdp::endCall(static_cast<uint64_t>(functionID),
+               static_cast<uint64_t>(timestamp), 0);
+}
 
-  uint64_t start =
-    db->getDynamicInfo().matchingStart(static_cast<uint64_t>(functionID));
+// Used instead of start/end when only calls that take longer than
+// native_xrt_trace_min_duration_us are traced.  XRT only knows if a
+// call is traced once it has ended, so the whole call is reported at
+// once.
+extern "C"
+void native_function_complete(const char* functionName,
+                              unsigned long long int /*functionID*/,
+                              unsigned long long int start,
+                              unsigned long long int end)
+{
+  if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
+    return;
 
-  xdp::VTFEvent* event =
-    new xdp::NativeAPICall(start,
-                           static_cast<double>(timestamp),
-                           db->getDynamicInfo().addString(functionName));
-  db->getDynamicInfo().addUnsortedEvent(event);
+  xdp::completeCall(functionName, static_cast<uint64_t>(start),
+                    static_cast<uint64_t>(end));
 }
 
-// Callbacks for sync functions will create two separate events to be displayed
-// on the visualization.  One that is put on the API row to show that
+// Sync calls are displayed as two separate events on the
+// visualization.  One that is put on the API row to show that
 // xrt::sync was called, and one on the data transfer rows to show when
 // reads and writes were occurring.
 extern "C"
@@ -107,92 +169,31 @@ void native_sync_start(const char* functionName,
   if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
     return;
 
-  // Don't include the profiling overhead in the time that we show.
-  // That means there will be "empty gaps" in the timeline trace when
-  // the profiling overhead exists.  We do this by capturing the
-  // timestamp as close to the end of this function as possible
-  xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase();
-
-  // Create two different events.  One for capturing the API to be put
-  // on the API row, and one for the read/write data transfer rows.
-  xdp::VTFEvent* APIEvent      = nullptr;
-  xdp::VTFEvent* transferEvent = nullptr;
-
-  auto functionStr = db->getDynamicInfo().addString(functionName);
-  APIEvent = new xdp::NativeAPICall(0, 0, functionStr);
-  if (isWrite)
-    transferEvent = new xdp::NativeSyncWrite(0, 0, functionStr);
-  else
-    transferEvent = new xdp::NativeSyncRead(0, 0, functionStr);
-
-  db->getDynamicInfo().addUnsortedEvent(APIEvent);
-  db->getDynamicInfo().addUnsortedEvent(transferEvent);
-
-  // We need to store both events for lookup as we will only get one
-  // "stop" event from the XRT side for this particular functionID.
-  xdp::EventPair events = { APIEvent->getEventId(), transferEvent->getEventId() };
-  db->getDynamicInfo().markEventPairStart(static_cast<uint64_t>(functionID), events);
+  xdp::startCall(functionName, static_cast<uint64_t>(functionID),
+                 isWrite ? xdp::NativeEventType::SYNC_WRITE
+                         : xdp::NativeEventType::SYNC_READ);
+}
 
-  {
-    // For statistics, also keep track of the start time associated with
-    // this data transfer.
-    std::lock_guard<std::mutex> lock(xdp::timestampLock);
-    xdp::nativeTimestamps[static_cast<uint64_t>(functionID)] = xrt_core::time_ns();
-  }
+extern "C"
+void native_sync_end(const char* /*functionName*/, unsigned long long int functionID, unsigned long long int timestamp, bool /*isWrite*/, unsigned long long int size)
+{
+  if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
+    return;
 
-  db->getStats().logFunctionCallStart(functionName, static_cast<double>(xrt_core::time_ns()));
-  APIEvent->setTimestamp(static_cast<double>(xrt_core::time_ns()));
-  transferEvent->setTimestamp(static_cast<double>(xrt_core::time_ns()));
+  xdp::endCall(static_cast<uint64_t>(functionID),
+               static_cast<uint64_t>(timestamp),
+               static_cast<uint64_t>(size));
 }
 
+// Buffer to buffer copies are counted per copy path taken by XRT so
+// the summary shows whether copies are done by the device or through
+// the host.
 extern "C"
-void native_sync_end(const char* functionName, unsigned long long int functionID, unsigned long long int timestamp, bool isWrite, unsigned long long int size)
+void native_copy_path(const char* path, unsigned long long int size)
 {
   if (!xdp::VPDatabase::alive() || !xdp::NativeProfilingPlugin::alive())
     return;
 
   xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase();
-  db->getStats().logFunctionCallEnd(functionName, static_cast<double>(timestamp));
-
-  uint64_t startTimestamp = 0;
-  uint64_t transferTime = 0;
-  {
-    std::lock_guard<std::mutex> lock(xdp::timestampLock);
-    startTimestamp = xdp::nativeTimestamps[static_cast<uint64_t>(functionID)];
-    transferTime = timestamp - startTimestamp;
-    xdp::nativeTimestamps.erase(functionID);
-  }
-
-  // Retrieve the pair of events for this particular functionID.
-  auto startEvents =
-    db->getDynamicInfo().matchingEventPairStart(static_cast<uint64_t>(functionID));
-
-  xdp::VTFEvent* APIEvent = nullptr;
-  xdp::VTFEvent* transferEvent = nullptr;
-
-  auto functionStr = db->getDynamicInfo().addString(functionName);
-
-  APIEvent = new xdp::NativeAPICall(startEvents.APIEventId,
-                                    static_cast<double>(timestamp),
-                                    functionStr);
-
-  if (isWrite) {
-    transferEvent =
-      new xdp::NativeSyncWrite(startEvents.transferEventId,
-                               static_cast<double>(timestamp),
-                               functionStr);
-  }
-  else {
-    transferEvent =
-      new xdp::NativeSyncRead(startEvents.transferEventId,
-                              static_cast<double>(timestamp),
-                              db->getDynamicInfo().addString(functionName));
-  }
-  db->getDynamicInfo().addUnsortedEvent(APIEvent);
-  db->getDynamicInfo().addUnsortedEvent(transferEvent);
-
-  if (isWrite)
-    db->getStats().logHostWrite(0, 0, size, startTimestamp, transferTime, 0, 0);
-  else
-    db->getStats().logHostRead(0, 0, size, startTimestamp, transferTime, 0, 0);
+  db->getStats().logBufferCopy(path, static_cast<uint64_t>(size));
 }
@@ -30,6 +30,10 @@ extern "C"
 XDP_PLUGIN_EXPORT
 void native_function_end(const char* functionName, unsigned long long int functionID, unsigned long long int timestamp) ;
 
+extern "C"
+XDP_PLUGIN_EXPORT
+void native_function_complete(const char* functionName, unsigned long long int functionID, unsigned long long int start, unsigned long long int end) ;
+
 extern "C"
 XDP_PLUGIN_EXPORT
 void native_sync_start(const char* functionName, unsigned long long int functionID, bool isWrite) ;
@@ -38,4 +42,8 @@ extern "C"
 XDP_PLUGIN_EXPORT
 void native_sync_end(const char* functionName, unsigned long long int functionID, unsigned long long int timestamp, bool isWrite, unsigned long long int size);
 
+extern "C"
+XDP_PLUGIN_EXPORT
+void native_copy_path(const char* path, unsigned long long int size);
+
 #endif
@@ -0,0 +1,141 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NATIVE_EVENT_BUFFER_DOT_H
+#define NATIVE_EVENT_BUFFER_DOT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace xdp {
+
+  enum class NativeEventType : uint8_t {
+    API,
+    SYNC_READ,
+    SYNC_WRITE
+  };
+
+  // A completed Native XRT API call as recorded by the calling thread.
+  // The function name is the string literal passed by XRT, which is
+  // only converted to a string table entry when the record is drained.
+  struct NativeEventRecord
+  {
+    const char* functionName;
+    uint64_t start;
+    uint64_t end;
+    uint64_t size; // Bytes transferred by sync calls
+    NativeEventType type;
+  };
+
+  // Each thread making Native XRT API calls owns one of these buffers.
+  // The owning thread is the only producer and the plugin's drain
+  // thread is the only consumer, so records are exchanged through a
+  // fixed size ring without locks.  Start and end callbacks of a call
+  // always come from the same thread, so calls in progress are
+  // matched in a thread private stack rather than in the database.
+  class NativeEventBuffer
+  {
+  public:
+    static constexpr uint64_t capacity = 4096; // Must be power of two
+
+  private:
+    struct OpenCall
+    {
+      uint64_t functionId;
+      const char* functionName;
+      uint64_t start;
+      NativeEventType type;
+    };
+
+    std::array<NativeEventRecord, capacity> records;
+    alignas(64) std::atomic<uint64_t> head {0}; // Written by owning thread
+    alignas(64) std::atomic<uint64_t> tail {0}; // Written by drain thread
+    std::atomic<bool> retired {false};
+
+    std::thread::id threadId = std::this_thread::get_id();
+    std::vector<OpenCall> openCalls; // Accessed by owning thread only
+
+  public:
+    NativeEventBuffer()
+    {
+      openCalls.reserve(16);
+    }
+
+    std::thread::id getThreadId() const { return threadId; }
+
+    // Mark the start of an API call by the owning thread
+    void startCall(uint64_t functionId, const char* functionName,
+                   uint64_t timestamp, NativeEventType type)
+    {
+      openCalls.push_back({functionId, functionName, timestamp, type});
+    }
+
+    // Complete the API call started with the same function id and
+    // return the completed record.  Returns false if the start of the
+    // call was not recorded.
+    bool endCall(uint64_t functionId, uint64_t timestamp, uint64_t size,
+                 NativeEventRecord& record)
+    {
+      // Normally the innermost call, search in case of out of order ends
+      for (auto itr = openCalls.rbegin(); itr != openCalls.rend(); ++itr) {
+        if (itr->functionId != functionId)
+          continue;
+
+        record = {itr->functionName, itr->start, timestamp, size, itr->type};
+        openCalls.erase(std::next(itr).base());
+        return true;
+      }
+      return false;
+    }
+
+    // Add a completed record.  Returns false if the ring is full, in
+    // which case the caller must process the record itself.
+    bool push(const NativeEventRecord& record)
+    {
+      auto h = head.load(std::memory_order_relaxed);
+      if (h - tail.load(std::memory_order_acquire) == capacity)
+        return false;
+
+      records[h & (capacity - 1)] = record;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Called by the drain thread only.  Process all records currently
+    // in the ring.
+    template <typename Process>
+    uint64_t drain(Process&& process)
+    {
+      auto t = tail.load(std::memory_order_relaxed);
+      auto h = head.load(std::memory_order_acquire);
+      for (auto i = t; i != h; ++i)
+        process(records[i & (capacity - 1)]);
+      tail.store(h, std::memory_order_release);
+      return h - t;
+    }
+
+    // The owning thread has exited, no more records will be added
+    void retire() { retired = true; }
+    bool isRetired() const { return retired; }
+  };
+
+} // end namespace xdp
+
+#endif
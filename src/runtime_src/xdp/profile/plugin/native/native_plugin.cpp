@@ -17,6 +17,10 @@
 
 #define XDP_PLUGIN_SOURCE
 
+#include <algorithm>
+#include <chrono>
+
+#include "xdp/profile/database/events/native_events.h"
 #include "xdp/profile/plugin/native/native_plugin.h"
 #include "xdp/profile/writer/native/native_writer.h"
 #include "xdp/profile/plugin/vp_base/info.h"
@@ -40,7 +44,17 @@ namespace xdp {
 
   NativeProfilingPlugin::~NativeProfilingPlugin()
   {
+    // Stop the drain thread, then move any remaining events into the
+    // database before writing
+    {
+      std::lock_guard<std::mutex> lock(buffersLock) ;
+      finished = true ;
+    }
+    endDraining() ;
+
     if (VPDatabase::alive()) {
+      drainBuffers() ;
+
       // Applications using the Native API may be running hardware emulation,
       //  so be sure to account for any emulation specific information
       emulationSetup() ;
@@ -55,4 +69,138 @@ namespace xdp {
     NativeProfilingPlugin::live = false;
   }
 
+  void NativeProfilingPlugin::writeAll(bool openNewFiles)
+  {
+    // Called by the database when it is destroyed before the plugin,
+    // or when it is reset.  The drain thread must not touch the
+    // database while the events are written.
+    endDraining() ;
+    drainBuffers() ;
+
+    XDPPlugin::writeAll(openNewFiles) ;
+
+    if (openNewFiles)
+      startDraining() ;
+  }
+
+  void NativeProfilingPlugin::registerBuffer(std::shared_ptr<NativeEventBuffer> buffer)
+  {
+    {
+      std::lock_guard<std::mutex> lock(buffersLock) ;
+      buffers.push_back(std::move(buffer)) ;
+    }
+    startDraining() ;
+  }
+
+  void NativeProfilingPlugin::startDraining()
+  {
+    std::lock_guard<std::mutex> lock(buffersLock) ;
+    if (finished || drainThread.joinable())
+      return ;
+
+    {
+      std::lock_guard<std::mutex> drain(drainLock) ;
+      keepDraining = true ;
+    }
+    drainThread = std::thread(&NativeProfilingPlugin::drainLoop, this) ;
+  }
+
+  void NativeProfilingPlugin::endDraining()
+  {
+    std::thread thread ;
+    {
+      std::lock_guard<std::mutex> lock(buffersLock) ;
+      if (!drainThread.joinable())
+        return ;
+      thread = std::move(drainThread) ;
+    }
+
+    {
+      std::lock_guard<std::mutex> drain(drainLock) ;
+      keepDraining = false ;
+    }
+    drainCond.notify_one() ;
+    thread.join() ;
+  }
+
+  void NativeProfilingPlugin::processRecord(const NativeEventRecord& record,
+                                            std::thread::id threadId)
+  {
+    auto& dynamicInfo = db->getDynamicInfo() ;
+    auto functionStr = dynamicInfo.addStaticString(record.functionName) ;
+    auto start = static_cast<double>(record.start) ;
+    auto end = static_cast<double>(record.end) ;
+
+    VTFEvent* APIStart = new NativeAPICall(0, start, functionStr) ;
+    dynamicInfo.addUnsortedEvent(APIStart) ;
+    dynamicInfo.addUnsortedEvent(new NativeAPICall(APIStart->getEventId(), end, functionStr)) ;
+
+    db->getStats().logFunctionCall(record.functionName, threadId, start, end) ;
+
+    if (record.type == NativeEventType::API)
+      return ;
+
+    // Sync calls are also shown on the data transfer rows
+    auto transferTime = record.end - record.start ;
+    if (record.type == NativeEventType::SYNC_WRITE) {
+      VTFEvent* transferStart = new NativeSyncWrite(0, start, functionStr) ;
+      dynamicInfo.addUnsortedEvent(transferStart) ;
+      dynamicInfo.addUnsortedEvent(new NativeSyncWrite(transferStart->getEventId(), end, functionStr)) ;
+      db->getStats().logHostWrite(0, 0, record.size, record.start, transferTime, 0, 0) ;
+    }
+    else {
+      VTFEvent* transferStart = new NativeSyncRead(0, start, functionStr) ;
+      dynamicInfo.addUnsortedEvent(transferStart) ;
+      dynamicInfo.addUnsortedEvent(new NativeSyncRead(transferStart->getEventId(), end, functionStr)) ;
+      db->getStats().logHostRead(0, 0, record.size, record.start, transferTime, 0, 0) ;
+    }
+  }
+
+  void NativeProfilingPlugin::drainBuffers()
+  {
+    std::vector<std::shared_ptr<NativeEventBuffer>> current ;
+    {
+      std::lock_guard<std::mutex> lock(buffersLock) ;
+      current = buffers ;
+    }
+
+    std::vector<NativeEventBuffer*> finished ;
+    for (auto& buffer : current) {
+      // Check for retirement before draining, anything added before the
+      // owning thread exited is then guaranteed to be drained
+      if (buffer->isRetired())
+        finished.push_back(buffer.get()) ;
+
+      auto threadId = buffer->getThreadId() ;
+      buffer->drain([this, threadId](const NativeEventRecord& record) {
+        processRecord(record, threadId) ;
+      }) ;
+    }
+
+    if (finished.empty())
+      return ;
+
+    // Forget buffers of threads that have exited
+    std::lock_guard<std::mutex> lock(buffersLock) ;
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [&finished](const auto& buffer) {
+                                   return std::find(finished.begin(), finished.end(), buffer.get()) != finished.end() ;
+                                 }),
+                  buffers.end()) ;
+  }
+
+  void NativeProfilingPlugin::drainLoop()
+  {
+    std::unique_lock<std::mutex> lock(drainLock) ;
+    while (keepDraining) {
+      drainCond.wait_for(lock, std::chrono::milliseconds(drainIntervalMs)) ;
+      if (!keepDraining || !VPDatabase::alive())
+        continue ;
+
+      lock.unlock() ;
+      drainBuffers() ;
+      lock.lock() ;
+    }
+  }
+
 } // end namespace xdp
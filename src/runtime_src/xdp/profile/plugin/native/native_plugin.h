@@ -17,6 +17,13 @@
 #ifndef NATIVE_PLUGIN_DOT_H
 #define NATIVE_PLUGIN_DOT_H
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xdp/profile/plugin/native/native_event_buffer.h"
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 
 namespace xdp {
@@ -25,11 +32,38 @@ namespace xdp {
   {
   private:
     static bool live;
+
+    // Per thread event buffers are drained into the database by a
+    // background thread so the API callbacks never take a lock.  The
+    // thread is started when the first buffer is registered and is
+    // stopped before the plugin writes its files.
+    std::vector<std::shared_ptr<NativeEventBuffer>> buffers;
+    std::mutex buffersLock; // Protects "buffers", "drainThread", "finished"
+    bool finished = false;  // Drain thread is not restarted once set
+
+    bool keepDraining = false;
+    std::mutex drainLock; // Protects "keepDraining"
+    std::condition_variable drainCond;
+    std::thread drainThread;
+    static constexpr unsigned int drainIntervalMs = 5;
+
+    void drainBuffers() ;
+    void drainLoop() ;
+    void startDraining() ;
+    void endDraining() ;
   public:
     NativeProfilingPlugin() ;
     ~NativeProfilingPlugin() ;
 
     static bool alive() { return NativeProfilingPlugin::live; }
+
+    void registerBuffer(std::shared_ptr<NativeEventBuffer> buffer) ;
+
+    virtual void writeAll(bool openNewFiles) override ;
+
+    // Convert a completed call into database events and statistics
+    void processRecord(const NativeEventRecord& record,
+                       std::thread::id threadId) ;
   } ;
 
 } // end namespace xdp
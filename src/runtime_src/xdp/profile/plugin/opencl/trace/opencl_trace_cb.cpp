@@ -43,7 +43,7 @@ namespace xdp {
     VTFEvent* event = new OpenCLAPICall(0,
                                         timestamp,
                                         functionID,
-                                        (db->getDynamicInfo()).addString(functionName),
+                                        (db->getDynamicInfo()).addStaticString(functionName),
                                         queueAddress
                                         ) ;
     (db->getDynamicInfo()).addEvent(event) ;
@@ -65,7 +65,7 @@ namespace xdp {
     VTFEvent* event = new OpenCLAPICall(start,
                                         timestamp,
                                         functionID,
-                                        (db->getDynamicInfo()).addString(functionName),
+                                        (db->getDynamicInfo()).addStaticString(functionName),
                                         queueAddress) ;
     (db->getDynamicInfo()).addEvent(event) ;
   }
@@ -14,29 +14,218 @@
  * under the License.
  */
 
+// Offline processing of raw PL trace captured from a device.
+//
+// The raw trace file is streamed through the PL trace decoder in fixed
+// size chunks, so memory use does not depend on the size of the
+// capture.  Decoded events are written out every time the number of
+// packets given with -p has been decoded, the same way continuous
+// offload writes trace during a run: "output.csv", "1-output.csv",
+// "2-output.csv", and so on.  With -b the files are written in the
+// binary trace format, which trace_converter turns back into CSV.
+
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/device/pl_device_trace_logger.h"
 #include "xdp/profile/writer/device_trace/device_trace_writer.h"
 
+namespace {
+
+// Number of packets given to the decoder at once
+constexpr uint64_t chunkPackets = 1024 * 1024;
+
+// Default number of packets decoded before the events are written out
+constexpr uint64_t defaultPacketsPerFile = 8 * chunkPackets;
+
+// Provides the raw trace file one chunk of packets at a time.  On
+// Linux the file is memory mapped and pages are released once they
+// have been decoded.  Elsewhere each chunk is read into a buffer.
+class TraceFile
+{
+  uint64_t size = 0;
+  uint64_t offset = 0;
+  bool readError = false;
+#ifndef _WIN32
+  uint64_t released = 0;
+  int fd = -1;
+  char* base = nullptr;
+  size_t mappedSize = 0;
+#else
+  std::ifstream fin;
+  std::vector<uint64_t> buffer;
+#endif
+
+public:
+  explicit TraceFile(const std::string& name)
+  {
+#ifndef _WIN32
+    fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size == 0)
+      return;
+
+    auto mapped = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+      return;
+
+    base = static_cast<char*>(mapped);
+    mappedSize = static_cast<size_t>(sb.st_size);
+    size = static_cast<uint64_t>(sb.st_size);
+    madvise(base, size, MADV_SEQUENTIAL);
+#else
+    fin.open(name, std::ios::binary | std::ios::in | std::ios::ate);
+    if (!fin)
+      return;
+    size = static_cast<uint64_t>(fin.tellg());
+    fin.seekg(0);
+    buffer.resize(chunkPackets);
+#endif
+    // Only complete packets are decoded
+    size -= size % sizeof(uint64_t);
+  }
+
+  ~TraceFile()
+  {
+#ifndef _WIN32
+    if (base)
+      munmap(base, mappedSize);
+    if (fd >= 0)
+      close(fd);
+#endif
+  }
+
+  TraceFile(const TraceFile&) = delete;
+  TraceFile& operator=(const TraceFile&) = delete;
+
+  bool valid() const { return size != 0; }
+  bool failed() const { return readError; }
+  uint64_t numPackets() const { return size / sizeof(uint64_t); }
+
+  // Return the next chunk of packets and its size in bytes.  Returns
+  // nullptr at the end of the file or if the file cannot be read.
+  void* next(uint64_t& numBytes)
+  {
+    numBytes = std::min(size - offset, chunkPackets * sizeof(uint64_t));
+    if (numBytes == 0)
+      return nullptr;
+
+#ifndef _WIN32
+    auto chunk = base + offset;
+#else
+    if (!fin.read(reinterpret_cast<char*>(buffer.data()), numBytes)) {
+      readError = true;
+      return nullptr;
+    }
+    auto chunk = buffer.data();
+#endif
+    offset += numBytes;
+    return chunk;
+  }
+
+  // The decoder is done with everything returned so far
+  void release()
+  {
+#ifndef _WIN32
+    auto page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    auto end = offset - (offset % page);
+    if (end > released) {
+      madvise(base + released, end - released, MADV_DONTNEED);
+      released = end;
+    }
+#endif
+  }
+};
+
+void usage(const char* name)
+{
+  std::cout << "Usage: " << name
+            << " [-b] [-o <output file>] [-p <packets per file>]"
+            << " <Raw Trace File> <Xclbin>\n"
+            << "  -b  Write the device trace in the binary trace format\n"
+            << "  -o  Name of the device trace file (default output.csv,"
+            << " or output.bin with -b)\n"
+            << "  -p  Number of packets decoded before writing a trace file"
+            << " (default " << defaultPacketsPerFile << ")\n";
+}
+
+// Parse the -p value, returns false if it is not a number
+bool parsePacketsPerFile(const std::string& value, uint64_t& packetsPerFile)
+{
+  try {
+    packetsPerFile = std::max<uint64_t>(chunkPackets, std::stoull(value));
+    return true;
+  }
+  catch (const std::invalid_argument&) {
+    return false;
+  }
+  catch (const std::out_of_range&) {
+    return false;
+  }
+}
+
+} // end anonymous namespace
+
 int main(int argc, char* argv[])
 {
-  if (argc != 3) {
-    std::cout << "Usage: " << argv[0] << " <Raw Trace File> <Xclbin>\n";
-    return 0;
+  std::string outputFile;
+  bool binary = false;
+  uint64_t packetsPerFile = defaultPacketsPerFile;
+  std::vector<std::string> positional;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if ((arg == "-o" || arg == "-p") && i + 1 < argc) {
+      std::string value = argv[++i];
+      if (arg == "-o")
+        outputFile = value;
+      else if (!parsePacketsPerFile(value, packetsPerFile)) {
+        std::cerr << "Invalid number of packets per file " << value << std::endl;
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else if (arg == "-b")
+      binary = true;
+    else if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      return 0;
+    }
+    else
+      positional.push_back(arg);
   }
 
-  std::string traceFile  = argv[1];
-  std::string xclbinFile = argv[2];
+  if (positional.size() != 2) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (outputFile.empty())
+    outputFile = binary ? "output.bin" : "output.csv";
+
+  std::string traceFile  = positional[0];
+  std::string xclbinFile = positional[1];
 
-  std::ifstream fin(traceFile, std::ios::binary|std::ios::in);
-  if (!fin) {
+  TraceFile trace(traceFile);
+  if (!trace.valid()) {
     std::cerr << "Cannot open raw trace file " << traceFile << std::endl;
-    return 0;
+    return 1;
   }
 
   // Create a database to store and interpret the events
@@ -47,27 +236,46 @@ int main(int argc, char* argv[])
 
   db->getStaticInfo().updateDevice(deviceId, xclbinFile);
 
-  std::vector<uint64_t> traceData;
+  xdp::PLDeviceTraceLogger logger(deviceId);
+  xdp::DeviceTraceWriter writer(outputFile.c_str(), deviceId, "1.1",
+                                xdp::getCurrentDateTime(),
+                                xdp::getXRTVersion(),
+                                xdp::getToolVersion(),
+                                binary);
+
+  auto start = std::chrono::steady_clock::now();
 
-  uint64_t packet = 0;
-  char* ch = reinterpret_cast<char*>(&packet);
+  // Stream all packets through the decoder, writing out the decoded
+  //  events regularly so they do not accumulate in the database
+  uint64_t numBytes = 0;
+  uint64_t sinceLastWrite = 0;
+  while (void* chunk = trace.next(numBytes)) {
+    logger.processTraceData(chunk, numBytes);
+    trace.release();
 
-  while(fin.read(ch, 8)) {
-    traceData.push_back(packet);
+    sinceLastWrite += numBytes / sizeof(uint64_t);
+    if (sinceLastWrite >= packetsPerFile) {
+      writer.write(true);
+      sinceLastWrite = 0;
+    }
   }
-  fin.close();
+  logger.endProcessTraceData();
+  writer.write(false);
 
-  // Add all of the events to the database
-  xdp::PLDeviceTraceLogger logger(deviceId);
-  uint64_t numBytes = sizeof(uint64_t)*traceData.size();
-  logger.processTraceData(traceData.data(), numBytes);
+  if (trace.failed()) {
+    std::cerr << "Error reading raw trace file " << traceFile << std::endl;
+    return 1;
+  }
 
-  // Create a writer and have it write.
-  xdp::DeviceTraceWriter writer("output.csv", deviceId, "1.1", xdp::getCurrentDateTime(), xdp::getXRTVersion(), xdp::getToolVersion());
-  writer.write(false);
+  auto end = std::chrono::steady_clock::now();
 
-  fin.close();
+  // Report throughput.  Set device_trace_decode_threads in the [Debug]
+  //  section of xrt.ini to compare decoding thread counts.
+  double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "Processed " << trace.numPackets() << " packets in "
+            << seconds << " s ("
+            << (seconds > 0 ? trace.numPackets() / seconds / 1e6 : 0)
+            << " M packets/s)" << std::endl;
 
   return 0;
 }
-
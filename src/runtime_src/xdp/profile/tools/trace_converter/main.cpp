@@ -0,0 +1,58 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Convert device trace files written in the binary trace format
+// (device_trace_file_format=binary in xrt.ini) into the CSV trace
+// files the visualization tools read.
+
+#include <iostream>
+#include <string>
+
+#include "xdp/profile/writer/vp_base/binary_trace.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc != 2 && argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <Binary Trace File> [<CSV File>]\n"
+              << "  The CSV file defaults to the binary trace file name"
+              << " with a .csv extension\n";
+    return 0;
+  }
+
+  std::string binaryFile = argv[1];
+  std::string csvFile;
+  if (argc == 3) {
+    csvFile = argv[2];
+  }
+  else {
+    auto dot = binaryFile.find_last_of('.');
+    auto slash = binaryFile.find_last_of("/\\");
+    if (dot == std::string::npos ||
+        (slash != std::string::npos && dot < slash))
+      csvFile = binaryFile + ".csv";
+    else
+      csvFile = binaryFile.substr(0, dot) + ".csv";
+  }
+
+  std::string error;
+  if (!xdp::BinaryTrace::convertToCSV(binaryFile, csvFile, error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wrote " << csvFile << std::endl;
+  return 0;
+}
@@ -26,6 +26,31 @@ namespace xdp {
   constexpr uint64_t LARGE_DATA_WARN_THRESHOLD = 0xA00000;
   bool AIETraceWriter::largeDataWarning = false;
 
+  // 1 Megabyte of formatted trace per file write
+  constexpr size_t WRITE_BUFFER_SIZE = 0x100000;
+  // "0x", up to 8 hex digits and newline
+  constexpr size_t MAX_WORD_CHARS = 11;
+
+  // Format a trace word as std::hex would, followed by newline.
+  // Returns the number of characters written.
+  static size_t formatWord(char* out, uint32_t word)
+  {
+    static constexpr char digits[] = "0123456789abcdef";
+    char hex[8];
+    size_t n = 0;
+    do {
+      hex[n++] = digits[word & 0xF];
+      word >>= 4;
+    } while (word != 0);
+
+    out[0] = '0';
+    out[1] = 'x';
+    for (size_t i = 0; i < n; i++)
+      out[2 + i] = hex[n - 1 - i];
+    out[2 + n] = '\n';
+    return n + 3;
+  }
+
   AIETraceWriter::AIETraceWriter(const char* filename, uint64_t devId, uint64_t trStrmId,
                                  const std::string& version, 
                                  const std::string& creationTime, 
@@ -33,7 +58,8 @@ namespace xdp {
                                  const std::string& /*toolV*/)
     : VPTraceWriter(filename, version, creationTime, 6 /* us */),
       deviceId(devId),
-      traceStreamId(trStrmId)
+      traceStreamId(trStrmId),
+      writeBuffer(WRITE_BUFFER_SIZE)
 #if 0
       xrtVersion(xrtV),
       toolVersion(toolV)
@@ -80,7 +106,7 @@ namespace xdp {
 
     size_t num = traceData->buffer.size();
     if (num == 0) {
-      delete traceData;
+      (db->getDynamicInfo()).releaseAIETraceData(deviceId, traceData);
       return;
     }
 
@@ -95,6 +121,8 @@ namespace xdp {
       }
     }
 
+    char* out = writeBuffer.data();
+    size_t used = 0;
     for (size_t j = 0; j < num; j++) {
       void*    buf = traceData->buffer[j];
       if (nullptr == buf)
@@ -109,16 +137,16 @@ namespace xdp {
       uint32_t* dataBuffer = static_cast<uint32_t*>(buf);
       for (uint64_t i = 0; i < bufferSz; i++)
       {
-        fout << "0x" << std::hex << dataBuffer[i] << std::endl;
-        fout << std::flush;
+        if (used + MAX_WORD_CHARS > writeBuffer.size()) {
+          fout.write(out, used);
+          used = 0;
+        }
+        used += formatWord(out + used, dataBuffer[i]);
       }
-
-
-      // Free the memory immediately if we own it
-      if (traceData->owner)
-        delete[] (traceData->buffer[j]);
     }
-    delete traceData;
+    fout.write(out, used);
+    fout.flush();
+    (db->getDynamicInfo()).releaseAIETraceData(deviceId, traceData);
   }
 
   void AIETraceWriter::writeDependencies()
@@ -18,6 +18,7 @@
 #define AIE_TRACE_WRITER_H
 
 #include <string>
+#include <vector>
 
 #include "xdp/profile/writer/vp_base/vp_trace_writer.h"
 #include "xdp/profile/database/database.h"
@@ -41,6 +42,10 @@ namespace xdp {
    uint64_t deviceId;
    uint64_t traceStreamId;
 
+   // Trace words are formatted into this buffer, which is written
+   // to the file in one call each time it fills up
+   std::vector<char> writeBuffer;
+
   protected:
     virtual void writeHeader();
     virtual void writeStructure();
@@ -30,12 +30,19 @@ namespace xdp {
                                        const std::string& version,
                                        const std::string& creationTime,
                                        const std::string& xrtV,
-                                       const std::string& toolV)
+                                       const std::string& toolV,
+                                       bool binaryFormat)
     : VPTraceWriter(filename, version, creationTime, 9 /* ns */),
       xrtVersion(xrtV),
       toolVersion(toolV),
-      deviceId(devId)
+      deviceId(devId),
+      binary(binaryFormat)
   {
+    if (binary) {
+      fout.close();
+      fout.clear();
+      fout.open(getcurrentFileName(), std::ios::out | std::ios::binary);
+    }
   }
 
   DeviceTraceWriter::~DeviceTraceWriter()
@@ -322,6 +329,11 @@ namespace xdp {
   void DeviceTraceWriter::writeTraceEvents()
   {
     fout << "EVENTS\n";
+    writeDeviceEvents();
+  }
+
+  void DeviceTraceWriter::writeDeviceEvents()
+  {
     auto DeviceEvents = db->getDynamicInfo().moveDeviceEvents(deviceId);
 
     auto& loadedConfigs =
@@ -358,29 +370,20 @@ namespace xdp {
           continue; // Coverity - In case dynamic cast fails
         std::pair<XclbinInfo*, int32_t> index =
           std::make_pair(xclbin, cuId);
-        kernelEvent->dump(fout, cuBucketIdMap[index] + eventType - KERNEL);
-        // Also output the tool tips
-        for (const auto& iter : xclbin->pl.cus) {
-          ComputeUnitInstance* cu = iter.second;
-          if (cu->getAccelMon() == cuId) {
-            fout << "," << db->getDynamicInfo().addString(cu->getKernelName());
-            fout << "," << db->getDynamicInfo().addString(cu->getName());
-          }
-        }
-        fout << "\n";
+        writeEvent(kernelEvent, cuBucketIdMap[index] + eventType - KERNEL, xclbin);
       } else if(KERNEL_STALL_EXT_MEM == eventType
                 || KERNEL_STALL_DATAFLOW == eventType
                 || KERNEL_STALL_PIPE == eventType) {
         std::pair<XclbinInfo*, int32_t> index =
           std::make_pair(xclbin, cuId);
-        deviceEvent->dump(fout, cuBucketIdMap[index] + eventType - KERNEL);
+        writeEvent(deviceEvent, cuBucketIdMap[index] + eventType - KERNEL, xclbin);
       } else {
         // Memory or Stream Acceses
         uint32_t monId = deviceEvent->getMonitorId();
         DeviceMemoryAccess* memoryEvent = dynamic_cast<DeviceMemoryAccess*>(e.get());
         if (memoryEvent) {
           std::pair<XclbinInfo*, uint32_t> index =std::make_pair(xclbin, monId);
-          deviceEvent->dump(fout, aimBucketIdMap[index] + eventType - KERNEL_READ);
+          writeEvent(deviceEvent, aimBucketIdMap[index] + eventType - KERNEL_READ, xclbin);
           continue;
         }
         DeviceStreamAccess* streamEvent = dynamic_cast<DeviceStreamAccess*>(e.get());
@@ -388,9 +391,9 @@ namespace xdp {
           std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, monId);
           if (KERNEL_STREAM_READ == eventType || KERNEL_STREAM_READ_STALL == eventType
                                               || KERNEL_STREAM_READ_STARVE == eventType) {
-            deviceEvent->dump(fout, asmBucketIdMap[index] + eventType - KERNEL_STREAM_READ);
+            writeEvent(deviceEvent, asmBucketIdMap[index] + eventType - KERNEL_STREAM_READ, xclbin);
           } else {
-            deviceEvent->dump(fout, asmBucketIdMap[index] + eventType - KERNEL_STREAM_WRITE);
+            writeEvent(deviceEvent, asmBucketIdMap[index] + eventType - KERNEL_STREAM_WRITE, xclbin);
           }
           continue;
         }
@@ -400,6 +403,43 @@ namespace xdp {
 
   }
 
+  void DeviceTraceWriter::writeEvent(VTFDeviceEvent* event, uint32_t bucket,
+                                     XclbinInfo* xclbin)
+  {
+    VTFEventType eventType = event->getEventType();
+
+    // Kernel events are followed by the kernel and compute unit names
+    //  as tool tips
+    extras.clear();
+    if (KERNEL == eventType) {
+      for (const auto& iter : xclbin->pl.cus) {
+        ComputeUnitInstance* cu = iter.second;
+        if (cu->getAccelMon() == event->getCUId()) {
+          extras.push_back(db->getDynamicInfo().addString(cu->getKernelName()));
+          extras.push_back(db->getDynamicInfo().addString(cu->getName()));
+        }
+      }
+    }
+
+    if (!encoder) {
+      event->dump(fout, bucket);
+      if (KERNEL == eventType) {
+        for (auto extra : extras)
+          fout << "," << extra;
+        fout << "\n";
+      }
+      return;
+    }
+
+    auto memoryEvent = dynamic_cast<DeviceMemoryAccess*>(event);
+    if (memoryEvent)
+      extras.push_back(memoryEvent->getMemoryName());
+
+    encoder->addEvent(event->getEventId(), event->getStartId(),
+                      event->getTimestamp(), bucket, eventType,
+                      extras.data(), static_cast<uint32_t>(extras.size()));
+  }
+
   void DeviceTraceWriter::writeDependencies()
   {
     fout << "DEPENDENCIES\n";
@@ -418,24 +458,74 @@ namespace xdp {
 
     initialize();
 
+    if (binary) {
+      writeBinary();
+    }
+    else {
+      writeHeader();
+      fout << "\n";
+      writeStructure();
+      fout << "\n";
+      writeStringTable();
+      fout << "\n";
+      writeTraceEvents();
+      fout << "\n";
+      writeDependencies();
+      fout << "\n";
+    }
+
+    fout.flush();
+
+    if (openNewFile) {
+      switchFiles();
+      db->getStaticInfo().addOpenedFile(getcurrentFileName(),
+                                        binary ? "VP_TRACE_BINARY" : "VP_TRACE");
+    }
+    return true;
+  }
+
+  // The binary file keeps the header, structure, and string table as
+  //  text so converting it back produces the same CSV file.  Only the
+  //  events are encoded.
+  void DeviceTraceWriter::writeBinary()
+  {
+    BinaryTrace::writeFileHeader(fout);
+
+    auto section = BinaryTrace::beginSection(fout, BinaryTrace::TEXT);
     writeHeader();
     fout << "\n";
     writeStructure();
     fout << "\n";
     writeStringTable();
     fout << "\n";
-    writeTraceEvents();
+    fout << "EVENTS\n";
+    BinaryTrace::endSection(fout, section);
+
+    section = BinaryTrace::beginSection(fout, BinaryTrace::EVENTS);
+    {
+      BinaryTrace::EventEncoder eventEncoder(fout);
+      encoder = &eventEncoder;
+      writeDeviceEvents();
+      eventEncoder.flush();
+      encoder = nullptr;
+    }
+    BinaryTrace::endSection(fout, section);
+
+    section = BinaryTrace::beginSection(fout, BinaryTrace::TEXT);
     fout << "\n";
     writeDependencies();
     fout << "\n";
+    BinaryTrace::endSection(fout, section);
+  }
 
-    fout.flush();
-
-    if (openNewFile) {
-      switchFiles();
-      db->getStaticInfo().addOpenedFile(getcurrentFileName(), "VP_TRACE");
+  void DeviceTraceWriter::switchFiles()
+  {
+    VPTraceWriter::switchFiles();
+    if (binary) {
+      fout.close();
+      fout.clear();
+      fout.open(getcurrentFileName(), std::ios::out | std::ios::binary);
     }
-    return true;
   }
 
   void DeviceTraceWriter::initialize()
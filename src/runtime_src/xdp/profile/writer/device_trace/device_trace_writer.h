@@ -19,13 +19,17 @@
 #define HAL_DEVICE_TRACE_WRITER_DOT_H
 
 #include <string>
+#include <vector>
 
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/device/pl_device_intf.h"
+#include "xdp/profile/writer/vp_base/binary_trace.h"
 #include "xdp/profile/writer/vp_base/vp_trace_writer.h"
 
 namespace xdp {
 
+  class VTFDeviceEvent ;
+
   class DeviceTraceWriter : public VPTraceWriter
   {
   private:
@@ -41,6 +45,12 @@ namespace xdp {
 
     uint64_t deviceId;
 
+    // When set, events are written in the binary trace format instead
+    //  of CSV.  The encoder is only valid while events are written.
+    bool binary;
+    BinaryTrace::EventEncoder* encoder = nullptr;
+    std::vector<uint64_t> extras;
+
     // Helper function for making sure the database has enough information
     //  to print out all of the information it will need.
     void initialize() ;
@@ -56,18 +66,25 @@ namespace xdp {
     void writeFloatingMemoryTransfersStructure(XclbinInfo* xclbin, uint32_t& rowCount) ;
     void writeFloatingStreamTransfersStructure(XclbinInfo* xclbin, uint32_t& rowCount) ;
 
+    // Helper functions for the EVENTS section
+    void writeDeviceEvents() ;
+    void writeEvent(VTFDeviceEvent* event, uint32_t bucket, XclbinInfo* xclbin) ;
+    void writeBinary() ;
+
   protected:
     virtual void writeHeader() ;
     virtual void writeStructure() ;
     virtual void writeStringTable() ;
     virtual void writeTraceEvents() ;
     virtual void writeDependencies() ;
+    virtual void switchFiles() ;
 
   public:
     DeviceTraceWriter(const char* filename, uint64_t deviceId, const std::string& version,
 		      const std::string& creationTime,
 		      const std::string& xrtV,
-		      const std::string& toolV);
+		      const std::string& toolV,
+		      bool binaryFormat = false);
     
     ~DeviceTraceWriter() ;
 
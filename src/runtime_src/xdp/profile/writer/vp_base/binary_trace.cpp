@@ -0,0 +1,311 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_CORE_SOURCE
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "xdp/profile/database/events/vtf_event.h"
+#include "xdp/profile/writer/vp_base/binary_trace.h"
+
+namespace {
+
+  void putFixed(std::ostream& out, uint64_t value, int numBytes)
+  {
+    char bytes[8];
+    for (int i = 0; i < numBytes; ++i)
+      bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    out.write(bytes, numBytes);
+  }
+
+  bool getFixed(std::istream& in, uint64_t& value, int numBytes)
+  {
+    unsigned char bytes[8];
+    if (!in.read(reinterpret_cast<char*>(bytes), numBytes))
+      return false;
+    value = 0;
+    for (int i = 0; i < numBytes; ++i)
+      value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    return true;
+  }
+
+  void putVarint(std::string& buffer, uint64_t value)
+  {
+    while (value >= 0x80) {
+      buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+  }
+
+  bool getVarint(const unsigned char*& pos, const unsigned char* end,
+                 uint64_t& value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+      unsigned char byte = *pos++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  uint64_t zigzag(int64_t value)
+  {
+    return (static_cast<uint64_t>(value) << 1) ^
+           static_cast<uint64_t>(value >> 63);
+  }
+
+  int64_t unzigzag(uint64_t value)
+  {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  // Round a timestamp in ms to ns the same way printing it with a fixed
+  //  precision of 6 does.  The fma recovers the rounding error of the
+  //  multiplication so values close to half a ns are not rounded the
+  //  wrong way.
+  int64_t toNanoseconds(double ms)
+  {
+    double product = ms * 1.0e6;
+    double error = std::fma(ms, 1.0e6, -product);
+    double whole = std::floor(product);
+    double fraction = product - whole;
+
+    bool roundUp = (fraction > 0.5) ||
+      (fraction == 0.5 &&
+       (error > 0 || (error == 0 && std::fmod(whole, 2.0) != 0)));
+    return static_cast<int64_t>(whole) + (roundUp ? 1 : 0);
+  }
+
+  // Same text as printing the timestamp in ms with a fixed precision of 6
+  void writeTimestamp(std::ofstream& fout, int64_t ns)
+  {
+    if (ns < 0) {
+      fout << "-";
+      ns = -ns;
+    }
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), "%06lld",
+                  static_cast<long long>(ns % 1000000));
+    fout << (ns / 1000000) << "." << fraction;
+  }
+
+  bool decodeBlock(const std::vector<unsigned char>& block,
+                   uint32_t numRecords, std::ofstream& fout)
+  {
+    const unsigned char* pos = block.data();
+    const unsigned char* end = block.data() + block.size();
+
+    uint64_t previousId = 0;
+    int64_t previousTimestamp = 0;
+    for (uint32_t i = 0; i < numRecords; ++i) {
+      uint64_t type = 0, id = 0, startId = 0, timestamp = 0, bucket = 0;
+      uint64_t numExtras = 0;
+      if (!getVarint(pos, end, type) || !getVarint(pos, end, id) ||
+          !getVarint(pos, end, startId) || !getVarint(pos, end, timestamp) ||
+          !getVarint(pos, end, bucket) || !getVarint(pos, end, numExtras))
+        return false;
+
+      previousId += unzigzag(id);
+      previousTimestamp += unzigzag(timestamp);
+      uint64_t eventStartId =
+        (startId == 0) ? 0 : previousId - unzigzag(startId - 1);
+
+      fout << previousId << "," << eventStartId << ",";
+      writeTimestamp(fout, previousTimestamp);
+      fout << "," << bucket << ",";
+      xdp::VTFEvent(0, 0, static_cast<xdp::VTFEventType>(type))
+        .dumpType(fout, true);
+
+      for (uint64_t j = 0; j < numExtras; ++j) {
+        uint64_t extra = 0;
+        if (!getVarint(pos, end, extra))
+          return false;
+        fout << "," << extra;
+      }
+      fout << "\n";
+    }
+    return pos == end;
+  }
+
+} // end anonymous namespace
+
+namespace xdp::BinaryTrace {
+
+  void writeFileHeader(std::ostream& out)
+  {
+    out.write(magic, sizeof(magic));
+    putFixed(out, version, 4);
+  }
+
+  std::streampos beginSection(std::ostream& out, SectionType type)
+  {
+    putFixed(out, type, 4);
+    putFixed(out, 0, 8); // Filled in by endSection
+    return out.tellp();
+  }
+
+  void endSection(std::ostream& out, std::streampos start)
+  {
+    std::streampos end = out.tellp();
+    out.seekp(start - static_cast<std::streamoff>(8));
+    putFixed(out, static_cast<uint64_t>(end - start), 8);
+    out.seekp(end);
+  }
+
+  EventEncoder::EventEncoder(std::ostream& o) : out(o)
+  {
+    block.reserve(blockSize + 256);
+  }
+
+  EventEncoder::~EventEncoder()
+  {
+    flush();
+  }
+
+  void EventEncoder::addEvent(uint64_t id, uint64_t startId,
+                              double timestampMs, uint32_t bucket,
+                              uint32_t type, const uint64_t* extras,
+                              uint32_t numExtras)
+  {
+    auto timestamp = toNanoseconds(timestampMs);
+
+    putVarint(block, type);
+    putVarint(block, zigzag(static_cast<int64_t>(id - previousId)));
+    putVarint(block, (startId == 0) ? 0 :
+                     zigzag(static_cast<int64_t>(id - startId)) + 1);
+    putVarint(block, zigzag(timestamp - previousTimestamp));
+    putVarint(block, bucket);
+    putVarint(block, numExtras);
+    for (uint32_t i = 0; i < numExtras; ++i)
+      putVarint(block, extras[i]);
+
+    previousId = id;
+    previousTimestamp = timestamp;
+    ++numRecords;
+
+    if (block.size() >= blockSize)
+      flush();
+  }
+
+  void EventEncoder::flush()
+  {
+    if (numRecords == 0)
+      return;
+
+    putFixed(out, NONE, 4);
+    putFixed(out, numRecords, 4);
+    putFixed(out, block.size(), 4);
+    out.write(block.data(), block.size());
+
+    block.clear();
+    numRecords = 0;
+    previousId = 0;
+    previousTimestamp = 0;
+  }
+
+  bool convertToCSV(const std::string& binaryFile, const std::string& csvFile,
+                    std::string& error)
+  {
+    std::ifstream fin(binaryFile, std::ios::in | std::ios::binary);
+    if (!fin) {
+      error = "Cannot open " + binaryFile;
+      return false;
+    }
+
+    char fileMagic[sizeof(magic)];
+    uint64_t fileVersion = 0;
+    if (!fin.read(fileMagic, sizeof(fileMagic)) ||
+        std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+        !getFixed(fin, fileVersion, 4)) {
+      error = binaryFile + " is not a binary trace file";
+      return false;
+    }
+    if (fileVersion > version) {
+      error = binaryFile + " uses unsupported format version " +
+              std::to_string(fileVersion);
+      return false;
+    }
+
+    std::ofstream fout(csvFile);
+    if (!fout) {
+      error = "Cannot open " + csvFile;
+      return false;
+    }
+
+    std::vector<unsigned char> buffer;
+    uint64_t sectionType = 0;
+    while (getFixed(fin, sectionType, 4)) {
+      uint64_t length = 0;
+      if (!getFixed(fin, length, 8)) {
+        error = "Truncated section header";
+        return false;
+      }
+
+      if (sectionType == TEXT) {
+        buffer.resize(length);
+        if (!fin.read(reinterpret_cast<char*>(buffer.data()), length)) {
+          error = "Truncated text section";
+          return false;
+        }
+        fout.write(reinterpret_cast<const char*>(buffer.data()), length);
+        continue;
+      }
+
+      if (sectionType != EVENTS) {
+        // Sections added by later versions that have no CSV form
+        fin.seekg(length, std::ios::cur);
+        continue;
+      }
+
+      constexpr uint64_t blockHeaderSize = 12;
+      while (length >= blockHeaderSize) {
+        uint64_t codec = 0, numRecords = 0, size = 0;
+        getFixed(fin, codec, 4);
+        getFixed(fin, numRecords, 4);
+        if (!getFixed(fin, size, 4) || blockHeaderSize + size > length) {
+          error = "Truncated event block";
+          return false;
+        }
+        if (codec != NONE) {
+          error = "Unsupported event block codec " + std::to_string(codec);
+          return false;
+        }
+
+        buffer.resize(size);
+        if (!fin.read(reinterpret_cast<char*>(buffer.data()), size) ||
+            !decodeBlock(buffer, static_cast<uint32_t>(numRecords), fout)) {
+          error = "Corrupt event block";
+          return false;
+        }
+        length -= blockHeaderSize + size;
+      }
+      if (length != 0) {
+        error = "Corrupt events section";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+} // end namespace xdp::BinaryTrace
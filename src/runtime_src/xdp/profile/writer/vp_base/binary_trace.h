@@ -0,0 +1,109 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef BINARY_TRACE_DOT_H
+#define BINARY_TRACE_DOT_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "xdp/config.h"
+
+// A compact binary alternative to the CSV trace files.
+//
+// A binary trace file starts with an 8 byte magic string and a 32 bit
+// format version.  The rest of the file is a sequence of sections,
+// each a 32 bit section type and a 64 bit payload length followed by
+// the payload.  All integers are little endian.
+//
+//  - TEXT sections hold parts of the CSV file that are small and
+//    written once per file (header, structure, string table).  They
+//    are copied to the CSV file as they are.
+//  - EVENTS sections hold trace events as a sequence of blocks.  Each
+//    block has a 32 bit codec, record count and size, followed by the
+//    records.  Every record is a series of variable length integers:
+//    event type, id (delta from the previous record), start id (0 for
+//    start events, otherwise one more than the zigzag encoded
+//    difference from the id), timestamp in ns (delta from the previous
+//    record), bucket,
+//    number of extra fields, and the extra fields.  Deltas restart in
+//    every block so blocks can be decoded independently.
+//
+// Converting a binary trace file to CSV produces the same file the CSV
+// writer would have produced.
+
+namespace xdp::BinaryTrace {
+
+  constexpr char magic[8] = {'X', 'D', 'P', 'B', 'T', 'R', 'C', '\0'};
+  constexpr uint32_t version = 1;
+
+  enum SectionType : uint32_t {
+    TEXT   = 1,
+    EVENTS = 2
+  };
+
+  // Only uncompressed blocks are written today.  The codec allows
+  //  compressed blocks to be added without a new format version.
+  enum Codec : uint32_t {
+    NONE = 0
+  };
+
+  XDP_CORE_EXPORT void writeFileHeader(std::ostream& out);
+
+  // Start a section.  The returned position is passed to endSection,
+  //  which fills in the length once the payload has been written.
+  XDP_CORE_EXPORT std::streampos beginSection(std::ostream& out,
+                                              SectionType type);
+  XDP_CORE_EXPORT void endSection(std::ostream& out, std::streampos start);
+
+  // Encodes trace events into blocks of an EVENTS section
+  class EventEncoder
+  {
+  private:
+    static constexpr size_t blockSize = 64 * 1024;
+
+    std::ostream& out;
+    std::string block;
+    uint32_t numRecords = 0;
+    uint64_t previousId = 0;
+    int64_t previousTimestamp = 0;
+
+  public:
+    XDP_CORE_EXPORT explicit EventEncoder(std::ostream& o);
+    XDP_CORE_EXPORT ~EventEncoder();
+
+    EventEncoder(const EventEncoder&) = delete;
+    EventEncoder& operator=(const EventEncoder&) = delete;
+
+    // Timestamps are in ms, stored with ns resolution
+    XDP_CORE_EXPORT void addEvent(uint64_t id, uint64_t startId,
+                                  double timestampMs, uint32_t bucket,
+                                  uint32_t type, const uint64_t* extras,
+                                  uint32_t numExtras);
+    XDP_CORE_EXPORT void flush();
+  };
+
+  // Convert a binary trace file into the CSV trace file the CSV writer
+  //  would have produced.  Returns false if the file cannot be read or
+  //  is not a supported binary trace file.
+  XDP_CORE_EXPORT bool convertToCSV(const std::string& binaryFile,
+                                    const std::string& csvFile,
+                                    std::string& error);
+
+} // end namespace xdp::BinaryTrace
+
+#endif
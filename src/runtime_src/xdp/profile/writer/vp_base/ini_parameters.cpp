@@ -34,11 +34,29 @@ namespace xdp {
                  "Enable the top level of host trace");
     addParameter("native_xrt_trace", xrt_core::config::get_native_xrt_trace(),
                  "Generation of Native XRT API function trace");
+    addParameter("native_xrt_trace_sample_rate",
+                 xrt_core::config::get_native_xrt_trace_sample_rate(),
+                 "Trace only 1 in N calls of each Native XRT API");
+    addParameter("native_xrt_trace_min_duration_us",
+                 xrt_core::config::get_native_xrt_trace_min_duration_us(),
+                 "Trace only Native XRT API calls taking at least this many microseconds");
+    addParameter("native_xrt_trace_functions",
+                 xrt_core::config::get_native_xrt_trace_functions(),
+                 "Comma separated Native XRT APIs, classes, or namespaces to trace (empty traces all)");
+    addParameter("api_call_samples",
+                 xrt_core::config::get_api_call_samples(),
+                 "Keep the duration of every API call for exact percentiles in the summary");
     addParameter("xrt_trace", xrt_core::config::get_xrt_trace(),
                  "Generation of hardware SHIM function trace");
     addParameter("device_trace",
                  xrt_core::config::get_device_trace(),
                  "Collection of data from PL monitors and added to summary and trace");
+    addParameter("device_trace_file_format",
+                 xrt_core::config::get_device_trace_file_format(),
+                 "Format of device trace files (csv|binary)");
+    addParameter("device_trace_decode_threads",
+                 xrt_core::config::get_device_trace_decode_threads(),
+                 "Number of threads decoding PL trace (0 uses all hardware threads)");
     addParameter("power_profile", xrt_core::config::get_power_profile(),
                  "Polling of power data during execution of application");
     addParameter("power_profile_interval_ms",
@@ -156,6 +174,9 @@ namespace xdp {
     addParameter("AIE_trace_settings.buffer_offload_interval_us",
                  xrt_core::config::get_aie_trace_settings_buffer_offload_interval_us(),
                  "Interval for reading of device AI Engine trace data to host (in us)");
+    addParameter("AIE_trace_settings.adaptive_offload_interval",
+                 xrt_core::config::get_aie_trace_settings_adaptive_offload_interval(),
+                 "Adapt the AI Engine trace offload interval to the trace data rate");
     addParameter("AIE_trace_settings.file_dump_interval_s",
                  xrt_core::config::get_aie_trace_settings_file_dump_interval_s(),
                  "Interval for dumping AI Engine trace files to host (in s)");
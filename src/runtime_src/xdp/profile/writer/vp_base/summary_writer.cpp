@@ -17,6 +17,9 @@
 
 #define XDP_CORE_SOURCE
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/common/config_reader.h"
 #include "core/common/sysinfo.h"
 
@@ -37,6 +40,15 @@
 
 // Anonymous namespace for static helper functions
 namespace {
+  // Nearest rank percentile of sorted durations
+  double exactPercentile(const std::vector<double>& sorted, double fraction)
+  {
+    if (sorted.empty())
+      return 0 ;
+    auto rank = static_cast<size_t>(std::ceil(fraction * sorted.size())) ;
+    return sorted[(rank == 0) ? 0 : rank - 1] ;
+  }
+
   bool AIMsExistOnComputeUnits()
   {
     xdp::VPDatabase* db = xdp::VPDatabase::Instance();
@@ -192,66 +204,77 @@ namespace xdp {
   {
     // For each function call, across all of the threads,
     //  consolidate all the information into what we need
-    std::map<std::string,
-             std::tuple<uint64_t,
-                        double,
-                        double,
-                        double> > rows ;
-
-    std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount =
-      (db->getStats()).getCallCount() ;
-
-    for (const auto& call : callCount) {
-      auto callAndThread = call.first ;
-      auto APIName = callAndThread.first ;
+    std::map<std::string, CallStatistics> rows ;
 
+    auto keep = [this, type](const std::string& APIName) {
       switch (type) {
       case OPENCL:
-        if (OpenCLAPIs.find(APIName) == OpenCLAPIs.end()) continue ;
-        break ;
+        return OpenCLAPIs.find(APIName) != OpenCLAPIs.end() ;
       case NATIVE:
-        if (NativeAPIs.find(APIName) == NativeAPIs.end()) continue ;
-        break ;
+        return NativeAPIs.find(APIName) != NativeAPIs.end() ;
       case HAL:
-        if (HALAPIs.find(APIName) == HALAPIs.end()) continue ;
-        break ;
+        return HALAPIs.find(APIName) != HALAPIs.end() ;
       case ALL: // Intentionally fall through
       default:
-        break ;
+        return true ;
       }
+    } ;
 
-      std::vector<std::pair<double, double>> timesOfCalls = call.second ;
-
-      if (rows.find(APIName) == rows.end()) {
-        std::tuple<uint64_t, double, double, double> blank =
-          std::make_tuple<uint64_t, double, double, double>(0,0,std::numeric_limits<double>::max(),0) ;
-
-        rows[APIName] = blank ;
-      }
-
-      for (const auto& executionTime : timesOfCalls) {
-        auto timeTaken = executionTime.second - executionTime.first ;
+    for (const auto& call : (db->getStats()).getCallStats()) {
+      auto APIName = call.first.first ;
+      if (!keep(APIName)) continue ;
+      rows[APIName].merge(call.second) ;
+    }
 
-        ++(std::get<0>(rows[APIName])) ;
-        std::get<1>(rows[APIName]) += timeTaken ;
-        if (timeTaken < std::get<2>(rows[APIName]))
-          std::get<2>(rows[APIName]) = timeTaken ;
-        if (timeTaken > std::get<3>(rows[APIName]))
-          std::get<3>(rows[APIName]) = timeTaken ;
+    // If the duration of every call was kept, report exact percentiles
+    //  instead of the histogram approximations
+    std::map<std::string, std::vector<double>> samples ;
+    if (type != OPENCL && (db->getStats()).callSamplesPresent()) {
+      for (const auto& call : (db->getStats()).getCallSamples()) {
+        auto APIName = call.first.first ;
+        if (!keep(APIName)) continue ;
+        auto& durations = samples[APIName] ;
+        for (const auto& executionTime : call.second)
+          durations.push_back(executionTime.second - executionTime.first) ;
       }
+      for (auto& durations : samples)
+        std::sort(durations.second.begin(), durations.second.end()) ;
     }
 
     for (const auto& row : rows) {
-      auto averageTime =
-        static_cast<double>(std::get<1>(row.second)) / static_cast<double>(std::get<0>(row.second)) ;
+      const auto& stats = row.second ;
+      double p50 = stats.histogram.percentile(0.50) ;
+      double p90 = stats.histogram.percentile(0.90) ;
+      double p99 = stats.histogram.percentile(0.99) ;
+      auto sampleIter = samples.find(row.first) ;
+      if (sampleIter != samples.end()) {
+        p50 = exactPercentile(sampleIter->second, 0.50) ;
+        p90 = exactPercentile(sampleIter->second, 0.90) ;
+        p99 = exactPercentile(sampleIter->second, 0.99) ;
+      }
+      else {
+        // Histogram buckets are approximate, stay within observed values
+        p50 = std::clamp(p50, stats.minTime, stats.maxTime) ;
+        p90 = std::clamp(p90, stats.minTime, stats.maxTime) ;
+        p99 = std::clamp(p99, stats.minTime, stats.maxTime) ;
+      }
+
       if (type != OPENCL) fout << "ENTRY:" ;
-      fout << row.first                      << ","     // API Name
-           << std::get<0>(row.second)        << ","     // Number of calls
-           << (std::get<1>(row.second)/one_million) << ","     // Total time
-           << (std::get<2>(row.second)/one_million) << ","     // Minimum time
-           << (averageTime/one_million)             << ","     // Average time
-           << (std::get<3>(row.second)/one_million) << ",\n" ; // Maximum time
+      fout << row.first                          << ","     // API Name
+           << stats.count                        << ","     // Number of calls
+           << (stats.totalTime/one_million)      << ","     // Total time
+           << (stats.minTime/one_million)        << ","     // Minimum time
+           << (stats.averageTime/one_million)    << ","     // Average time
+           << (stats.maxTime/one_million)        << "," ;   // Maximum time
+
+      // The plain OpenCL table has a fixed set of columns, the other
+      //  tables describe their columns and also report the spread
+      if (type != OPENCL)
+        fout << (std::sqrt(stats.getVariance())/one_million) << "," // Std dev
+             << (p50/one_million)                  << ","     // Median time
+             << (p90/one_million)                  << ","     // 90th percentile
+             << (p99/one_million)                  << "," ;   // 99th percentile
+      fout << "\n" ;
     }
   }
 
@@ -265,6 +288,18 @@ namespace xdp {
     writeAPICalls(OPENCL) ;
   }
 
+  void SummaryWriter::writeAPICallPercentileColumns()
+  {
+    fout << "COLUMN:<html>Standard<br>Deviation (ms)</html>,float,"
+         << "Standard deviation of execution time (in ms),\n";
+    fout << "COLUMN:<html>Median<br>Time (ms)</html>,float,"
+         << "Median execution time (in ms),\n";
+    fout << "COLUMN:<html>90th Percentile<br>Time (ms)</html>,float,"
+         << "90th percentile of execution time (in ms),\n";
+    fout << "COLUMN:<html>99th Percentile<br>Time (ms)</html>,float,"
+         << "99th percentile of execution time (in ms),\n";
+  }
+
   void SummaryWriter::writeNativeAPICalls()
   {
     fout << "TITLE:Native API Calls\n" ;
@@ -280,6 +315,7 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
+    writeAPICallPercentileColumns() ;
     writeAPICalls(NATIVE) ;
   }
 
@@ -298,6 +334,7 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
+    writeAPICallPercentileColumns() ;
     writeAPICalls(HAL) ;
   }
 
@@ -1898,6 +1935,32 @@ namespace xdp {
     }
   }
 
+  void SummaryWriter::writeBufferCopies()
+  {
+    if (!db->getStats().bufferCopyInformationPresent())
+      return ;
+
+    fout << "TITLE:Buffer Copies\n" ;
+    fout << "SECTION:Host Data Transfers,Buffer Copies\n" ;
+    fout << "COLUMN:<html>Copy<br>Path</html>,string,"
+         << "Mechanism used to copy between buffers,\n" ;
+    fout << "COLUMN:<html>Number<br>Of Copies</html>,int,"
+         << "Number of buffer copies using this path,\n" ;
+    fout << "COLUMN:<html>Total<br>Size (KB)</html>,float,"
+         << "Total size of copies using this path (in KB),\n" ;
+    fout << "COLUMN:<html>Average<br>Size (KB)</html>,float,"
+         << "Average size of copies using this path (in KB),\n" ;
+
+    for (const auto& iter : db->getStats().getBufferCopies()) {
+      auto count = iter.second.first ;
+      auto totalKB = static_cast<double>(iter.second.second) / one_thousand ;
+      fout << "ENTRY:" << iter.first << ","
+           << count << ","
+           << totalKB << ","
+           << totalKB / static_cast<double>(count) << ",\n" ;
+    }
+  }
+
   void SummaryWriter::writeUserLevelEvents()
   {
     if (!db->getStats().eventInformationPresent()) return ;
@@ -1990,6 +2053,7 @@ namespace xdp {
       writeHostWritesToGlobalMemory() ;                  fout << "\n" ;
       writeTopSyncReads() ;                              fout << "\n" ;
       writeTopSyncWrites() ;                             fout << "\n" ;
+      writeBufferCopies() ;                              fout << "\n" ;
     }
 
     if (db->infoAvailable(info::hal)) {
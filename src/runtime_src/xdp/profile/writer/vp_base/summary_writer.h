@@ -55,6 +55,7 @@ namespace xdp {
     // Generic host tables
     enum APIType { OPENCL, NATIVE, HAL, ALL } ;
     void writeAPICalls(APIType type) ;
+    void writeAPICallPercentileColumns() ;
 
     // OpenCL specific device tables
     void writeSoftwareEmulationComputeUnitUtilization() ;
@@ -95,6 +96,7 @@ namespace xdp {
     void writeHostWritesToGlobalMemory() ;
     void writeTopSyncReads() ;
     void writeTopSyncWrites() ;
+    void writeBufferCopies() ;
 
     // HAL tables
     void writeHALAPICalls() ;
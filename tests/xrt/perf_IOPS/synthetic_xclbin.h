@@ -0,0 +1,73 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+#ifndef PERF_IOPS_SYNTHETIC_XCLBIN_H
+#define PERF_IOPS_SYNTHETIC_XCLBIN_H
+
+// In memory xclbins with only an EMBEDDED_METADATA section, used by
+// the tests that measure loading of xclbin meta data
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xclbin.h"
+
+// XML meta data for kernels with args arguments each and one compute
+// unit per kernel.  The project name makes the meta data of otherwise
+// identical xclbins differ.
+inline std::string
+create_xml(size_t kernels, size_t args, const std::string& project = "synthetic")
+{
+  std::ostringstream xml;
+  xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<project name=\"" << project << "\">\n"
+      << " <platform>\n"
+      << "  <device name=\"fpga0\" fpgaDevice=\"synthetic\">\n"
+      << "   <core name=\"OCL_REGION_0\">\n";
+
+  for (size_t k = 0; k < kernels; ++k) {
+    xml << "    <kernel name=\"kernel_" << k << "\" language=\"c\" type=\"\">\n"
+        << "     <port name=\"S_AXI_CONTROL\" mode=\"slave\" range=\"0x1000\" dataWidth=\"32\"/>\n"
+        << "     <port name=\"M_AXI_GMEM\" mode=\"master\" range=\"0xFFFFFFFF\" dataWidth=\"512\"/>\n";
+    for (size_t a = 0; a < args; ++a)
+      xml << "     <arg name=\"arg_" << a << "\" addressQualifier=\"1\" id=\"" << a
+          << "\" port=\"M_AXI_GMEM\" size=\"0x8\" offset=\"0x" << std::hex << (0x10 + a * 8) << std::dec
+          << "\" hostOffset=\"0x0\" hostSize=\"0x8\" type=\"int*\"/>\n";
+    xml << "     <instance name=\"kernel_" << k << "_1\">\n"
+        << "      <addrRemap base=\"0x" << std::hex << (0x1000000 + k * 0x10000) << std::dec
+        << "\" port=\"S_AXI_CONTROL\"/>\n"
+        << "     </instance>\n"
+        << "    </kernel>\n";
+  }
+
+  xml << "   </core>\n"
+      << "  </device>\n"
+      << " </platform>\n"
+      << "</project>\n";
+  return xml.str();
+}
+
+// xclbin with the xml as its only section, id is stored in the uuid
+inline std::vector<char>
+create_xclbin(const std::string& xml, unsigned int id)
+{
+  std::vector<char> data(sizeof(axlf) + xml.size());
+  auto top = reinterpret_cast<axlf*>(data.data());
+  std::strcpy(top->m_magic, "xclbin2");
+  top->m_header.m_length = data.size();
+  top->m_header.m_numSections = 1;
+  std::memcpy(top->m_header.uuid, &id, sizeof(id));
+
+  auto& hdr = top->m_sections[0];
+  hdr.m_sectionKind = EMBEDDED_METADATA;
+  hdr.m_sectionOffset = sizeof(axlf);
+  hdr.m_sectionSize = xml.size();
+  std::memcpy(data.data() + sizeof(axlf), xml.data(), xml.size());
+  return data;
+}
+
+#endif
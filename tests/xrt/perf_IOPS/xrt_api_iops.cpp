@@ -11,6 +11,7 @@
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_bo.h"
 #include "xrt/xrt_kernel.h"
+#include "experimental/xrt_kernel.h"
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
@@ -77,6 +78,50 @@ testSingleThread(const xrt::device& device, const xrt::uuid& uuid)
   }
 }
 
+// Start commands in batches using xrt::start, wait for the batch to
+// complete before starting next batch
+static double
+runBatchTest(std::vector<xrt::run>& cmds, size_t batch_size, unsigned int total)
+{
+  std::vector<xrt::run> batch(cmds.begin(), cmds.begin() + batch_size);
+  unsigned int completed = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+
+  while (completed < total) {
+    xrt::start(batch);
+    for (auto& cmd : batch)
+      cmd.wait();
+
+    completed += batch_size;
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  return (std::chrono::duration_cast<std::chrono::microseconds>(end - start)).count();
+}
+
+static void
+testBatch(const xrt::device& device, const xrt::uuid& uuid)
+{
+  std::vector<size_t> batch_sizes = { 1, 10, 100, 500, 1000 };
+  unsigned int total = 100000;
+
+  auto hello = xrt::kernel(device, uuid.get(), "hello");
+
+  std::vector<xrt::run> cmds;
+  for (size_t i = 0; i < batch_sizes.back(); i++) {
+    auto run = xrt::run(hello);
+    run.set_arg(0, xrt::bo(device, 20, hello.group_id(0)));
+    cmds.push_back(std::move(run));
+  }
+
+  for (auto batch_size : batch_sizes) {
+    double duration = runBatchTest(cmds, batch_size, total);
+    std::cout << "Batch: " << std::setw(7) << batch_size
+              << " iops: " << (total * 1000.0 * 1000.0 / duration)
+              << std::endl;
+  }
+}
+
 static int
 _main(int argc, char* argv[])
 {
@@ -91,6 +136,7 @@ _main(int argc, char* argv[])
   auto uuid = device.load_xclbin(xclbin_fn);
 
   testSingleThread(device, uuid);
+  testBatch(device, uuid);
 
   return 0;
 }
@@ -0,0 +1,101 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Measure xrt::bo::copy() latency and bandwidth for copy sizes from
+// 64 bytes to 1GB (or the size specified with -m).
+//
+// The path used for the copies (m2m, kdma, host) depends on the
+// device and on xrt.ini Runtime.cdma.  Enable native_xrt_trace in the
+// [Debug] section of xrt.ini to have the copy path reported in the
+// Buffer Copies table of the profile summary.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#ifdef _WIN32
+# pragma warning( disable : 4244 )
+#endif
+
+static void usage()
+{
+  std::cout  << "Usage: test -k <xclbin> [-m <max bytes>]\n";
+}
+
+// Total number of bytes to copy for each size, bounds the number of
+// iterations for large copies
+constexpr size_t bytes_per_size = 4ULL * 1024 * 1024 * 1024;
+constexpr size_t max_iterations = 10000;
+
+// Return average time in us of copying sz bytes from src to dst
+static double
+runTest(xrt::bo& dst, const xrt::bo& src, size_t sz)
+{
+  auto iterations = std::clamp<size_t>(bytes_per_size / sz, 1, max_iterations);
+
+  // warm up
+  dst.copy(src, sz);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    dst.copy(src, sz);
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+static int
+_main(int argc, char* argv[])
+{
+  if (argc < 3 || argv[1] != std::string("-k")) {
+    usage();
+    return 1;
+  }
+
+  std::string xclbin_fn = argv[2];
+  size_t max_size = 1024 * 1024 * 1024;
+  if (argc == 5 && argv[3] == std::string("-m"))
+    max_size = std::stoull(argv[4]);
+
+  auto device = xrt::device(0);
+  auto uuid = device.load_xclbin(xclbin_fn);
+  auto hello = xrt::kernel(device, uuid, "hello");
+
+  auto src = xrt::bo(device, max_size, hello.group_id(0));
+  auto dst = xrt::bo(device, max_size, hello.group_id(0));
+  std::memset(src.map<char*>(), 'x', max_size);
+  src.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  for (size_t sz = 64; sz <= max_size; sz *= 4) {
+    auto us = runTest(dst, src, sz);
+    std::cout << "Size: " << std::setw(10) << sz
+              << " us/copy: " << std::setw(10) << us
+              << " MB/s: " << sz / us
+              << std::endl;
+  }
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  try {
+    return _main(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+};
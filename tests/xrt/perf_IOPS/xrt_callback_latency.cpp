@@ -0,0 +1,154 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Measure the cost of managed command completion as a function of
+// the number of outstanding commands.  Each xrt::run has a completion
+// callback, which makes execution managed by the command monitor.
+// Each callback immediately restarts its run, so the number of
+// outstanding commands stays constant while the test runs.
+//
+// Run with and without xrt.ini Runtime.cmd_completion_lanes=true to
+// compare lane tracking with scanning of all running commands.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#ifdef _WIN32
+# pragma warning( disable : 4244 )
+#endif
+
+static void usage()
+{
+  std::cout  << "Usage: test -k <xclbin> [-n <completions>]\n";
+}
+
+struct context
+{
+  std::vector<xrt::run> runs;
+  size_t total = 0;
+  std::atomic<size_t> issued {0};
+  std::atomic<size_t> completed {0};
+  std::atomic<size_t> errors {0};
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+struct run_data
+{
+  context* ctx;
+  size_t idx;
+};
+
+static void
+on_complete(const void*, ert_cmd_state state, void* data)
+{
+  auto rd = static_cast<run_data*>(data);
+  auto ctx = rd->ctx;
+
+  // Callbacks run in the command monitor thread, do not throw
+  if (state != ERT_CMD_STATE_COMPLETED)
+    ctx->errors++;
+
+  if (ctx->issued.fetch_add(1) < ctx->total)
+    ctx->runs[rd->idx].start();
+
+  if (++ctx->completed < ctx->total)
+    return;
+
+  std::lock_guard lk(ctx->mutex);
+  ctx->done.notify_all();
+}
+
+// Return average time per completion in us
+static double
+runTest(const xrt::device& device, const xrt::kernel& hello, size_t outstanding, size_t total)
+{
+  context ctx;
+  std::vector<run_data> data(outstanding);
+  std::vector<xrt::bo> bos;
+  for (size_t i = 0; i < outstanding; ++i) {
+    auto run = xrt::run(hello);
+    bos.emplace_back(device, 20, hello.group_id(0));
+    run.set_arg(0, bos.back());
+    data[i] = {&ctx, i};
+    run.add_callback(ERT_CMD_STATE_COMPLETED, on_complete, &data[i]);
+    ctx.runs.push_back(std::move(run));
+  }
+
+  // Each run must complete at least once
+  ctx.total = std::max(total, outstanding);
+  ctx.issued = outstanding;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (auto& run : ctx.runs)
+    run.start();
+
+  {
+    std::unique_lock lk(ctx.mutex);
+    ctx.done.wait(lk, [&ctx] { return ctx.completed == ctx.total; });
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (ctx.errors)
+    throw std::runtime_error("commands failed to complete");
+
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  return static_cast<double>(us) / ctx.total;
+}
+
+static int
+_main(int argc, char* argv[])
+{
+  if (argc < 3 || argv[1] != std::string("-k")) {
+    usage();
+    return 1;
+  }
+
+  std::string xclbin_fn = argv[2];
+  size_t total = 100000;
+  if (argc == 5 && argv[3] == std::string("-n"))
+    total = std::stoul(argv[4]);
+
+  auto device = xrt::device(0);
+  auto uuid = device.load_xclbin(xclbin_fn);
+  auto hello = xrt::kernel(device, uuid, "hello");
+
+  std::vector<size_t> outstanding = { 1, 10, 100, 1000, 5000, 10000 };
+  for (auto num : outstanding) {
+    auto us = runTest(device, hello, num, total);
+    std::cout << "Outstanding: " << std::setw(6) << num
+              << " us/completion: " << us
+              << std::endl;
+  }
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  try {
+    return _main(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+};
@@ -0,0 +1,210 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Compare cold and warm loads of xclbin meta data with the metadata
+// cache enabled.
+//
+// The test points XRT_INI_PATH at an xrt.ini that enables the cache
+// in a new temporary directory, which is removed when done.  The first
+// load of each synthetic xclbin parses the XML meta data and stores it
+// in the cache (cold), later loads read it back from the cache
+// (warm).  The xclbins are loaded round robin so that no load reuses
+// the XML meta data parsed by the previous one.  Every warm load is
+// compared field by field with the cold load of the same xclbin.  Use
+// -x to run with the cache disabled for comparison.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "experimental/xrt_xclbin.h"
+#include "synthetic_xclbin.h"
+
+static void
+usage()
+{
+  std::cout << "Usage: test [-n <max kernels>] [-a <args per kernel>] [-i <iterations>] [-x]\n"
+            << "  -x  disable the metadata cache\n";
+}
+
+// Point XRT at an xrt.ini in a new temporary directory.  Must be
+// called before any other XRT call, the configuration is read once.
+static std::filesystem::path
+setup_ini(bool cache)
+{
+  std::ostringstream name;
+  name << "xrt_metadata_cache." << std::hex << std::random_device{}();
+  auto dir = std::filesystem::temp_directory_path() / name.str();
+  std::filesystem::create_directories(dir);
+
+  auto ini = dir / "xrt.ini";
+  std::ofstream ofs(ini);
+  ofs << "[Runtime]\n";
+  if (cache)
+    ofs << "metadata_cache_dir=" << (dir / "cache").string() << "\n";
+  ofs.close();
+
+#ifdef _WIN32
+  _putenv_s("XRT_INI_PATH", ini.string().c_str());
+#else
+  setenv("XRT_INI_PATH", ini.string().c_str(), 1);
+#endif
+  return dir;
+}
+
+template <typename ValueType>
+static void
+expect_equal(const ValueType& parsed, const ValueType& cached, const std::string& what)
+{
+  if (parsed != cached)
+    throw std::runtime_error("cached meta data differs from parsed meta data: " + what);
+}
+
+// Compare the meta data of an xclbin loaded from the cache with the
+// meta data parsed from the same xclbin
+static void
+compare(const xrt::xclbin& parsed, const xrt::xclbin& cached)
+{
+  expect_equal(parsed.get_uuid(), cached.get_uuid(), "uuid");
+  expect_equal(parsed.get_fpga_device_name(), cached.get_fpga_device_name(), "fpga device name");
+
+  auto parsed_kernels = parsed.get_kernels();
+  auto cached_kernels = cached.get_kernels();
+  expect_equal(parsed_kernels.size(), cached_kernels.size(), "number of kernels");
+
+  for (size_t k = 0; k < parsed_kernels.size(); ++k) {
+    const auto& pk = parsed_kernels[k];
+    const auto& ck = cached_kernels[k];
+    auto kname = pk.get_name();
+    expect_equal(kname, ck.get_name(), "kernel name");
+    expect_equal(pk.get_type(), ck.get_type(), kname + " type");
+    expect_equal(pk.get_num_args(), ck.get_num_args(), kname + " number of args");
+
+    auto parsed_args = pk.get_args();
+    auto cached_args = ck.get_args();
+    expect_equal(parsed_args.size(), cached_args.size(), kname + " args");
+    for (size_t a = 0; a < parsed_args.size(); ++a) {
+      const auto& pa = parsed_args[a];
+      const auto& ca = cached_args[a];
+      auto aname = kname + "." + pa.get_name();
+      expect_equal(pa.get_name(), ca.get_name(), aname + " name");
+      expect_equal(pa.get_index(), ca.get_index(), aname + " index");
+      expect_equal(pa.get_port(), ca.get_port(), aname + " port");
+      expect_equal(pa.get_size(), ca.get_size(), aname + " size");
+      expect_equal(pa.get_offset(), ca.get_offset(), aname + " offset");
+      expect_equal(pa.get_host_type(), ca.get_host_type(), aname + " host type");
+    }
+  }
+}
+
+// Load the xclbin meta data, time in ms is added to elapsed
+static xrt::xclbin
+load(const std::vector<char>& data, size_t kernels, double& elapsed)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  xrt::xclbin xclbin{reinterpret_cast<const axlf*>(data.data())};
+  if (xclbin.get_kernels().size() != kernels)
+    throw std::runtime_error("unexpected number of kernels in xclbin");
+  auto end = std::chrono::high_resolution_clock::now();
+  elapsed += std::chrono::duration<double, std::milli>(end - start).count();
+  return xclbin;
+}
+
+static int
+run(size_t max_kernels, size_t args, size_t iterations)
+{
+  std::vector<size_t> sizes;
+  std::vector<std::vector<char>> xclbins;
+  std::vector<size_t> xml_sizes;
+  for (size_t kernels = 1; kernels <= max_kernels; kernels *= 10) {
+    auto xml = create_xml(kernels, args);
+    xclbins.push_back(create_xclbin(xml, static_cast<unsigned int>(sizes.size() + 1)));
+    xml_sizes.push_back(xml.size());
+    sizes.push_back(kernels);
+  }
+
+  std::vector<double> cold(sizes.size());
+  std::vector<xrt::xclbin> parsed;
+  for (size_t idx = 0; idx < sizes.size(); ++idx)
+    parsed.push_back(load(xclbins[idx], sizes[idx], cold[idx]));
+
+  std::vector<double> warm(sizes.size());
+  for (size_t iter = 0; iter < iterations; ++iter)
+    for (size_t idx = 0; idx < sizes.size(); ++idx)
+      compare(parsed[idx], load(xclbins[idx], sizes[idx], warm[idx]));
+
+  for (auto& ms : warm)
+    ms /= iterations;
+
+  for (size_t idx = 0; idx < sizes.size(); ++idx)
+    std::cout << "Kernels: " << std::setw(6) << sizes[idx]
+              << " xml KB: " << std::setw(8) << xml_sizes[idx] / 1024
+              << " cold ms: " << std::setw(10) << cold[idx]
+              << " warm ms: " << std::setw(10) << warm[idx]
+              << "\n";
+
+  return 0;
+}
+
+static int
+_main(int argc, char* argv[])
+{
+  size_t max_kernels = 1000;
+  size_t args = 8;
+  size_t iterations = 10;
+  bool cache = true;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc)
+      max_kernels = std::stoull(argv[++i]);
+    else if (arg == "-a" && i + 1 < argc)
+      args = std::stoull(argv[++i]);
+    else if (arg == "-i" && i + 1 < argc)
+      iterations = std::max<size_t>(std::stoull(argv[++i]), 1);
+    else if (arg == "-x")
+      cache = false;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  auto dir = setup_ini(cache);
+  std::cout << "Metadata cache: " << (cache ? (dir / "cache").string() : "disabled") << "\n";
+
+  try {
+    auto ret = run(max_kernels, args, iterations);
+    std::filesystem::remove_all(dir);
+    return ret;
+  }
+  catch (...) {
+    std::filesystem::remove_all(dir);
+    throw;
+  }
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return _main(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
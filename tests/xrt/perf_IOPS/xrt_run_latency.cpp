@@ -0,0 +1,174 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Measure round trip latency of xrt::run::start() followed by
+// xrt::run::wait() for one outstanding command at a time.
+//
+// Run with and without xrt.ini Runtime.exec_wait_spin_us to compare
+// busy polling of command state with blocking exec_wait.
+//
+// The cost of restarting a run after changing an argument is measured
+// for comparison with restarting an unchanged run.  The cost of
+// xrt::run::update_arg(), which submits an ERT_INIT_CU command, is
+// measured for comparison with set_arg().
+//
+// Also measure the cost of constructing xrt::run objects, which is
+// dominated by command buffer allocation unless the buffer is drawn
+// from the command BO pool (xrt.ini Runtime.exec_bo_pool_size).
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#ifdef _WIN32
+# pragma warning( disable : 4244 )
+#endif
+
+static void usage()
+{
+  std::cout  << "Usage: test -k <xclbin> [-n <iterations>]\n";
+}
+
+static void
+report(const std::string& label, std::vector<double>& us)
+{
+  std::sort(us.begin(), us.end());
+  auto avg = std::accumulate(us.begin(), us.end(), 0.0) / us.size();
+  auto pct = [&us](double p) { return us[static_cast<size_t>(p * (us.size() - 1))]; };
+  std::cout << std::setw(20) << label
+            << " min: " << us.front()
+            << " avg: " << avg
+            << " p50: " << pct(0.50)
+            << " p99: " << pct(0.99)
+            << " max: " << us.back()
+            << " (us)" << std::endl;
+}
+
+// Return latency in us of each start / wait round trip
+static std::vector<double>
+runTest(xrt::run& run, size_t iterations)
+{
+  std::vector<double> us;
+  us.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    run.start();
+    run.wait();
+    auto end = std::chrono::high_resolution_clock::now();
+    us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  return us;
+}
+
+// Return latency in us of each set_arg / start / wait round trip
+static std::vector<double>
+runSetArgTest(xrt::run& run, const xrt::bo& bo, size_t iterations)
+{
+  std::vector<double> us;
+  us.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    run.set_arg(0, bo);
+    run.start();
+    run.wait();
+    auto end = std::chrono::high_resolution_clock::now();
+    us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  return us;
+}
+
+// Return latency in us of each update_arg, which submits and waits
+// for an ERT_INIT_CU command
+static std::vector<double>
+updateArgTest(xrt::run& run, const xrt::bo& bo, size_t iterations)
+{
+  std::vector<double> us;
+  us.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    run.update_arg(0, bo);
+    auto end = std::chrono::high_resolution_clock::now();
+    us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  return us;
+}
+
+// Return latency in us of each xrt::run construction and destruction
+static std::vector<double>
+createTest(const xrt::kernel& kernel, size_t iterations)
+{
+  std::vector<double> us;
+  us.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+      auto run = xrt::run(kernel);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  return us;
+}
+
+static int
+_main(int argc, char* argv[])
+{
+  if (argc < 3 || argv[1] != std::string("-k")) {
+    usage();
+    return 1;
+  }
+
+  std::string xclbin_fn = argv[2];
+  size_t iterations = 100000;
+  if (argc == 5 && argv[3] == std::string("-n"))
+    iterations = std::stoul(argv[4]);
+
+  auto device = xrt::device(0);
+  auto uuid = device.load_xclbin(xclbin_fn);
+  auto hello = xrt::kernel(device, uuid, "hello");
+
+  auto bo = xrt::bo(device, 20, hello.group_id(0));
+  auto run = xrt::run(hello);
+  run.set_arg(0, bo);
+
+  // warm up
+  runTest(run, std::min<size_t>(iterations, 100));
+
+  auto us = runTest(run, iterations);
+  report("start/wait", us);
+
+  us = runSetArgTest(run, bo, iterations);
+  report("set_arg/start/wait", us);
+
+  us = updateArgTest(run, bo, iterations);
+  report("update_arg", us);
+
+  us = createTest(hello, iterations);
+  report("create", us);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  try {
+    return _main(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+};
@@ -0,0 +1,122 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ */
+
+// Measure the time to load xclbin meta data for synthetic xclbins
+// with 1 to 1000 kernels (or up to the number specified with -n).
+//
+// The xclbins are created in memory and contain only an
+// EMBEDDED_METADATA section, no device is needed.  The time reported
+// is for constructing xrt::xclbin and extracting its kernels, which
+// is dominated by processing the XML meta data.  Several xclbins with
+// different meta data are loaded in turn, the very first load is
+// reported separately.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "experimental/xrt_xclbin.h"
+#include "synthetic_xclbin.h"
+
+static void usage()
+{
+  std::cout  << "Usage: test [-n <max kernels>] [-a <args per kernel>]\n";
+}
+
+constexpr size_t max_iterations = 100;
+
+// Number of distinct xclbins loaded round robin per size
+constexpr size_t num_xclbins = 8;
+
+struct result
+{
+  double first_ms;  // first load of any xclbin
+  double avg_ms;    // average of the following loads
+};
+
+static double
+load(const std::vector<char>& data, size_t kernels)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  xrt::xclbin xclbin{reinterpret_cast<const axlf*>(data.data())};
+  if (xclbin.get_kernels().size() != kernels)
+    throw std::runtime_error("unexpected number of kernels in xclbin");
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Load distinct xclbins with the same number of kernels round robin,
+// so no load can reuse meta data left behind by the previous one
+static result
+runTest(const std::vector<std::vector<char>>& xclbins, size_t kernels)
+{
+  auto iterations = std::clamp<size_t>(10000 / kernels, xclbins.size(), max_iterations);
+
+  result res {};
+  res.first_ms = load(xclbins[0], kernels);
+
+  double total = 0;
+  for (size_t i = 1; i <= iterations; ++i)
+    total += load(xclbins[i % xclbins.size()], kernels);
+  res.avg_ms = total / iterations;
+  return res;
+}
+
+static int
+_main(int argc, char* argv[])
+{
+  size_t max_kernels = 1000;
+  size_t args = 8;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc)
+      max_kernels = std::stoull(argv[++i]);
+    else if (arg == "-a" && i + 1 < argc)
+      args = std::stoull(argv[++i]);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  unsigned int id = 0;
+  for (size_t kernels = 1; kernels <= max_kernels; kernels *= 10) {
+    std::vector<std::vector<char>> xclbins;
+    size_t xml_size = 0;
+    for (size_t i = 0; i < num_xclbins; ++i) {
+      auto xml = create_xml(kernels, args, "synthetic_" + std::to_string(++id));
+      xml_size = xml.size();
+      xclbins.push_back(create_xclbin(xml, id));
+    }
+
+    auto res = runTest(xclbins, kernels);
+    std::cout << "Kernels: " << std::setw(6) << kernels
+              << " xml KB: " << std::setw(8) << xml_size / 1024
+              << " first ms: " << std::setw(10) << res.first_ms
+              << " ms/load: " << std::setw(10) << res.avg_ms
+              << "\n";
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return _main(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}